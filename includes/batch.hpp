@@ -0,0 +1,35 @@
+#ifndef DA_PROJ2_BATCH_H
+#define DA_PROJ2_BATCH_H
+
+/**
+ * @brief Runs scenarios from the command line, without the user interface.
+ *
+ * @details Takes the datasets to solve, or every available dataset if none
+ *          are given, and these options:
+ *
+ *          - `-s, --scenarios LIST`: the scenarios to run, separated by commas,
+ *            from 1.1, 1.2, 2.1, 2.2, 2.3, 2.4 and 2.5 (all of them by
+ *            default).
+ *          - `-g, --group-size LIST`: the group sizes of scenarios 2.1 and
+ *            2.2, separated by commas. Each size gets its own row, and
+ *            scenario 2.1 is answered for all of them with a single flow.
+ *          - `-i, --increase N`: the group size increase of scenario 2.2.
+ *          - `-e, --engine NAME`: the flow algorithm, edmonds-karp (the
+ *            default), dinic or push-relabel.
+ *          - `-j, --threads N`: how many datasets to solve at once, or 0 to
+ *            use every core (1 by default).
+ *          - `-o, --output PATH`: where to write the results, or - for the
+ *            standard output (the default).
+ *          - `-f, --format csv|json`: the format of the results, json by
+ *            default if the output ends in .json and csv otherwise.
+ *
+ * @param argc The number of arguments, including the program's name.
+ * @param argv The arguments.
+ *
+ * @return The exit status: 0 if every dataset was solved, 1 if some couldn't
+ *         be solved or the output couldn't be written, and 2 if the arguments
+ *         are invalid.
+ */
+int runBatch(int argc, char **argv);
+
+#endif // DA_PROJ2_BATCH_H
@@ -0,0 +1,55 @@
+#ifndef DA_PROJ2_BITMAP_H
+#define DA_PROJ2_BITMAP_H
+
+class Bitmap;
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * @brief Represents a set of nodes as one bit per node.
+ *
+ * @details Used for the frontier of a bottom-up bfs, where every unvisited
+ *          node asks if its neighbours are in the frontier.
+ */
+class Bitmap {
+    /**
+     * @brief The bits, 64 nodes per word.
+     */
+    std::vector<uint64_t> words;
+
+public:
+    /**
+     * @brief Creates an empty bitmap.
+     */
+    Bitmap(){};
+
+    /**
+     * @brief Empties this bitmap and makes room for the nodes up to n.
+     *
+     * @param n The highest node this bitmap can hold.
+     */
+    void clear(int n) { words.assign(n / 64 + 1, 0); }
+
+    /**
+     * @brief Adds a node to this bitmap.
+     *
+     * @param node The node.
+     */
+    void set(int node) { words[node / 64] |= uint64_t{1} << (node % 64); }
+
+    /**
+     * @param node The node.
+     * @return Whether the given node is in this bitmap.
+     */
+    bool test(int node) const { return words[node / 64] >> (node % 64) & 1; }
+
+    /**
+     * @brief Swaps the contents of two bitmaps.
+     *
+     * @param other The other bitmap.
+     */
+    void swap(Bitmap &other) { words.swap(other.words); }
+};
+
+#endif // DA_PROJ2_BITMAP_H
@@ -0,0 +1,88 @@
+#ifndef DA_PROJ2_BUCKET_QUEUE_H
+#define DA_PROJ2_BUCKET_QUEUE_H
+
+class BucketQueue;
+
+#include <vector>
+
+/**
+ * @brief Represents a max priority queue of nodes with one bucket per key.
+ *
+ * @details Every node is in at most one bucket, kept as an intrusive doubly
+ *          linked list, so pushing and moving a node are O(1) and nothing is
+ *          allocated after the queue is built. The highest bucket is found by
+ *          walking down from the last one that was popped.
+ *
+ * @note The queue is monotone: keys that are pushed can't be higher than the
+ *       key of the last node that was popped, like in a widest path search.
+ */
+class BucketQueue {
+    /**
+     * @brief The lowest key a node can have.
+     */
+    int minKey = 0;
+    /**
+     * @brief The bucket of the highest key that may still have nodes.
+     */
+    int top = -1;
+    /**
+     * @brief The number of nodes in the queue.
+     */
+    int size = 0;
+
+    /**
+     * @brief The first node in each bucket, or -1 if it is empty.
+     */
+    std::vector<int> heads;
+    /**
+     * @brief The next node in the same bucket as each node.
+     */
+    std::vector<int> next;
+    /**
+     * @brief The previous node in the same bucket as each node.
+     */
+    std::vector<int> prev;
+    /**
+     * @brief The bucket each node is in, or -1 if it isn't in the queue.
+     */
+    std::vector<int> buckets;
+
+    /**
+     * @brief Takes a node out of its bucket.
+     *
+     * @param node The node.
+     */
+    void unlink(int node);
+
+public:
+    /**
+     * @brief Creates an empty queue.
+     *
+     * @param n The highest node that can be pushed.
+     * @param minKey The lowest key a node can have.
+     * @param maxKey The highest key a node can have.
+     */
+    BucketQueue(int n, int minKey, int maxKey);
+
+    /**
+     * @return Whether there are no nodes in the queue.
+     */
+    bool empty() const { return size == 0; }
+
+    /**
+     * @brief Adds a node to the queue, or moves it if it is already there.
+     *
+     * @param node The node.
+     * @param key The node's new key.
+     */
+    void push(int node, int key);
+
+    /**
+     * @brief Removes a node with the highest key from the queue.
+     *
+     * @return The node.
+     */
+    int pop();
+};
+
+#endif // DA_PROJ2_BUCKET_QUEUE_H
@@ -0,0 +1,100 @@
+#ifndef DA_PROJ2_BUFFERED_WRITER_H
+#define DA_PROJ2_BUFFERED_WRITER_H
+
+class BufferedWriter;
+
+#include <fstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @brief Writes numbers, characters and text to a file through a large
+ *        buffer.
+ *
+ * @details Numbers are formatted with std::to_chars straight into the buffer,
+ *          which is only handed to the file when it fills up, so writing
+ *          millions of small fields costs a handful of writes.
+ */
+class BufferedWriter {
+    /**
+     * @brief The size of the buffer, in bytes.
+     */
+    static constexpr size_t BUFFER_SIZE = 1 << 20;
+
+    /**
+     * @brief The file being written.
+     */
+    std::ofstream out;
+    /**
+     * @brief What has been written but not handed to the file yet.
+     */
+    std::vector<char> buffer;
+    /**
+     * @brief How much of the buffer is in use.
+     */
+    size_t used = 0;
+
+    /**
+     * @brief Hands the buffer to the file if it can't fit some more bytes.
+     *
+     * @param bytes How many bytes are about to be written.
+     */
+    void reserve(size_t bytes) {
+        if (used + bytes > buffer.size())
+            flush();
+    }
+
+public:
+    /**
+     * @brief Opens a file for writing, replacing it if it exists.
+     *
+     * @param path The path of the file.
+     */
+    explicit BufferedWriter(const std::string &path);
+
+    BufferedWriter(const BufferedWriter &) = delete;
+    BufferedWriter &operator=(const BufferedWriter &) = delete;
+
+    /**
+     * @brief Flushes the buffer and closes the file.
+     */
+    ~BufferedWriter() { flush(); }
+
+    /**
+     * @brief Writes a number in decimal.
+     *
+     * @param number The number.
+     */
+    void write(long long number);
+    /**
+     * @brief Writes a number in decimal.
+     *
+     * @param number The number.
+     */
+    void write(int number) { write((long long)number); }
+
+    /**
+     * @brief Writes a character.
+     *
+     * @param c The character.
+     */
+    void write(char c) {
+        reserve(1);
+        buffer[used++] = c;
+    }
+
+    /**
+     * @brief Writes some text.
+     *
+     * @param text The text.
+     */
+    void write(std::string_view text);
+
+    /**
+     * @brief Hands everything that was written to the file.
+     */
+    void flush();
+};
+
+#endif // DA_PROJ2_BUFFERED_WRITER_H
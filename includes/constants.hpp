@@ -15,6 +15,15 @@ const std::string OUTPUT_PATH = "outputs/";
  * @brief Where the scenario results will be stored in the datasets folder.
  */
 const std::string OUTPUT_FILE = "output.csv";
+/**
+ * @brief The extension of datasets saved as binary snapshots.
+ */
+const std::string SNAPSHOT_EXTENSION = ".csr";
+/**
+ * @brief The environment variable that, if set, has the path where a trace of
+ *        the run is written when the program exits.
+ */
+const std::string TRACE_VARIABLE = "DA_PROJ2_TRACE";
 /**
  * @brief The header to be printed at the start of the scenario results.
  */
@@ -25,13 +34,64 @@ const std::string OUTPUT_HEADER = "dataset,"
                                   "increase2_2,requiresNewPath2_2,runtime2_2,"
                                   "maxFlow2_3,runtime2_3,"
                                   "earliestFinish2_4,runtime2_4,"
-                                  "maxWaitTime2_5,runtime2_5\n";
+                                  "maxWaitTime2_5,runtime2_5,"
+                                  "runtime2_1Dinic,runtime2_2Dinic,"
+                                  "runtime2_3Dinic,"
+                                  "runtime2_1PushRelabel,runtime2_2PushRelabel,"
+                                  "runtime2_3PushRelabel,"
+                                  "cycles1_1,instructions1_1,cacheMisses1_1,"
+                                  "branchMisses1_1,pageFaults1_1,"
+                                  "cycles1_2,instructions1_2,cacheMisses1_2,"
+                                  "branchMisses1_2,pageFaults1_2,"
+                                  "cycles2_1,instructions2_1,cacheMisses2_1,"
+                                  "branchMisses2_1,pageFaults2_1,"
+                                  "cycles2_2,instructions2_2,cacheMisses2_2,"
+                                  "branchMisses2_2,pageFaults2_2,"
+                                  "cycles2_3,instructions2_3,cacheMisses2_3,"
+                                  "branchMisses2_3,pageFaults2_3,"
+                                  "cycles2_4,instructions2_4,cacheMisses2_4,"
+                                  "branchMisses2_4,pageFaults2_4,"
+                                  "cycles2_5,instructions2_5,cacheMisses2_5,"
+                                  "branchMisses2_5,pageFaults2_5,"
+                                  "allocatedBytes1_1,allocations1_1,peakRss1_1,"
+                                  "allocatedBytes1_2,allocations1_2,peakRss1_2,"
+                                  "allocatedBytes2_1,allocations2_1,peakRss2_1,"
+                                  "allocatedBytes2_2,allocations2_2,peakRss2_2,"
+                                  "allocatedBytes2_3,allocations2_3,peakRss2_3,"
+                                  "allocatedBytes2_4,allocations2_4,peakRss2_4,"
+                                  "allocatedBytes2_5,allocations2_5,"
+                                  "peakRss2_5,"
+                                  "augmentingPaths1_1,bfsPasses1_1,"
+                                  "nodesDequeued1_1,arcsScanned1_1,pushes1_1,"
+                                  "relabels1_1,minAugmentation1_1,"
+                                  "maxAugmentation1_1,"
+                                  "augmentingPaths1_2,bfsPasses1_2,"
+                                  "nodesDequeued1_2,arcsScanned1_2,pushes1_2,"
+                                  "relabels1_2,minAugmentation1_2,"
+                                  "maxAugmentation1_2,"
+                                  "augmentingPaths2_1,bfsPasses2_1,"
+                                  "nodesDequeued2_1,arcsScanned2_1,pushes2_1,"
+                                  "relabels2_1,minAugmentation2_1,"
+                                  "maxAugmentation2_1,"
+                                  "augmentingPaths2_2,bfsPasses2_2,"
+                                  "nodesDequeued2_2,arcsScanned2_2,pushes2_2,"
+                                  "relabels2_2,minAugmentation2_2,"
+                                  "maxAugmentation2_2,"
+                                  "augmentingPaths2_3,bfsPasses2_3,"
+                                  "nodesDequeued2_3,arcsScanned2_3,pushes2_3,"
+                                  "relabels2_3,minAugmentation2_3,"
+                                  "maxAugmentation2_3\n";
 /**
  * @brief The header to be printed at the start of dot files.
  */
 const std::string DOT_HEADER = "digraph {\n"
                                "overlap=scale\n"
                                "node [shape=circle]\n";
+/**
+ * @brief Graphs with more nodes than this are too large to visualize whole, so
+ *        the user is asked how much around the paths to show.
+ */
+const int VISUALIZATION_NODE_LIMIT = 500;
 /**
  * @brief How many items to print in each page in UserInterface#paginatedMenu().
  */
@@ -114,4 +174,15 @@ const std::string RESET_FORMATTING = "\33[0m";
  */
 const std::string PROGRAM_NAME = "DA - Project 2";
 
+/**
+ * @brief A bfs goes bottom-up once the edges leaving the frontier are more
+ *        than the edges reaching unvisited nodes divided by this.
+ */
+const int BFS_BOTTOM_UP_FACTOR = 14;
+/**
+ * @brief A bfs goes back to top-down once the frontier has less than the
+ *        number of nodes divided by this.
+ */
+const int BFS_TOP_DOWN_FACTOR = 24;
+
 #endif // DA_PROJ2_CONSTANTS_H
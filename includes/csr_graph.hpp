@@ -0,0 +1,350 @@
+#ifndef DA_PROJ2_CSR_GRAPH_H
+#define DA_PROJ2_CSR_GRAPH_H
+
+class CsrGraph;
+enum class FlowEngine;
+
+#include <climits>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./graph.hpp"
+#include "./traversal_workspace.hpp"
+
+/**
+ * @brief Represents an edge to be frozen into a CsrGraph.
+ */
+struct CsrEdge {
+    /** @brief The source node. */
+    int src;
+    /** @brief The destination node. */
+    int dest;
+    /** @brief This edge's capacity. */
+    int capacity;
+    /** @brief This edge's duration. */
+    int duration;
+};
+
+/**
+ * @brief Represents a frozen directed graph in compressed sparse row form.
+ *
+ * @details Nodes are labeled from 1 to n inclusive. The outgoing edges of node
+ *          u are the indices in [offsets[u], offsets[u + 1]) of the packed
+ *          edge arrays, sorted by destination.
+ *
+ * @note This graph can't be changed after being built, use a Graph to build
+ *       it. It can also be saved as a binary snapshot, which is mapped and
+ *       used as is when loaded.
+ */
+class CsrGraph {
+    /**
+     * @brief The number of nodes in this graph.
+     */
+    int n = 0;
+
+    /**
+     * @brief Keeps alive the memory the arrays below point to, either the
+     *        arrays this graph was built into or a mapped snapshot.
+     *
+     * @details The arrays never change, so copies of this graph share them.
+     */
+    std::shared_ptr<const void> storage;
+
+    /**
+     * @brief Where the edges of each node start in the packed edge arrays.
+     *
+     * @details Has n + 2 entries, so that offsets[u + 1] is always the end of
+     *          the edges of node u.
+     */
+    std::span<const int> offsets;
+    /**
+     * @brief The destination node of each edge.
+     */
+    std::span<const int> dests;
+    /**
+     * @brief The capacity of each edge.
+     */
+    std::span<const int> capacities;
+    /**
+     * @brief The duration of each edge.
+     */
+    std::span<const int> durations;
+    /**
+     * @brief The lowest capacity of an edge, or 0 if there are no edges.
+     */
+    int minCapacity = 0;
+    /**
+     * @brief The highest capacity of an edge, or 0 if there are no edges.
+     */
+    int maxCapacity = 0;
+
+    /**
+     * @brief Where the incoming edges of each node start in the reverse index.
+     *
+     * @details Has n + 2 entries, like #offsets.
+     */
+    std::span<const int> reverseOffsets;
+    /**
+     * @brief The source node of each edge in the reverse index.
+     */
+    std::span<const int> reverseSources;
+    /**
+     * @brief The index in the packed edge arrays of each edge in the reverse
+     *        index.
+     */
+    std::span<const int> reverseEdges;
+
+    /**
+     * @brief Builds the packed edge arrays and the reverse index.
+     *
+     * @details If there is more than one edge between the same two nodes, only
+     *          the first one is kept, like in Graph::addEdge().
+     *
+     * @param edges The edges, with nodes from 0 to n inclusive.
+     */
+    void build(const std::vector<CsrEdge> &edges);
+
+public:
+    /**
+     * @brief Creates an empty graph.
+     */
+    CsrGraph(){};
+    /**
+     * @brief Freezes a graph.
+     *
+     * @details The number of nodes will be the highest label in the given
+     *          graph.
+     *
+     * @param graph The graph to freeze.
+     */
+    explicit CsrGraph(const Graph &graph);
+    /**
+     * @brief Freezes a list of edges, without building a Graph first.
+     *
+     * @details If there is more than one edge between the same two nodes, only
+     *          the first one is kept, like in Graph::addEdge().
+     *
+     * @param n The number of nodes.
+     * @param edges The edges, with nodes from 1 to n inclusive.
+     */
+    CsrGraph(int n, const std::vector<CsrEdge> &edges);
+
+    /**
+     * @brief Loads a graph from a binary snapshot.
+     *
+     * @details The file is mapped read-only and the arrays are used straight
+     *          from it, so nothing is parsed or copied and processes that load
+     *          the same snapshot share it in the page cache. Only the
+     *          checksum and the checks of the arrays go through the whole
+     *          file.
+     *
+     * @param path The path of the snapshot.
+     *
+     * @throws ParseError If the file isn't a valid snapshot.
+     *
+     * @return The graph.
+     */
+    static CsrGraph loadSnapshot(const std::string &path);
+
+    /**
+     * @brief Saves this graph as a binary snapshot.
+     *
+     * @details The snapshot has a header, with a version and a checksum of the
+     *          rest of the file, followed by the arrays of this graph, in
+     *          native byte order.
+     *
+     * @param path The path of the snapshot.
+     *
+     * @return Whether the snapshot could be written.
+     */
+    bool saveSnapshot(const std::string &path) const;
+
+    /**
+     * @return The number of nodes in this graph.
+     */
+    int getN() const { return n; }
+    /**
+     * @return The number of edges in this graph.
+     */
+    int getEdgeCount() const { return dests.size(); }
+
+    /**
+     * @param node The node.
+     * @return The index of the first outgoing edge of the given node.
+     */
+    int edgesBegin(int node) const { return offsets[node]; }
+    /**
+     * @param node The node.
+     * @return One past the index of the last outgoing edge of the given node.
+     */
+    int edgesEnd(int node) const { return offsets[node + 1]; }
+
+    /**
+     * @param edge The index of the edge.
+     * @return The destination node of the edge.
+     */
+    int getDest(int edge) const { return dests[edge]; }
+    /**
+     * @param edge The index of the edge.
+     * @return The capacity of the edge.
+     */
+    int getCapacity(int edge) const { return capacities[edge]; }
+    /**
+     * @param edge The index of the edge.
+     * @return The duration of the edge.
+     */
+    int getDuration(int edge) const { return durations[edge]; }
+
+    /**
+     * @brief Finds the edge between two nodes.
+     *
+     * @param src The source node.
+     * @param dest The destination node.
+     * @return The index of the edge, or -1 if there is none.
+     */
+    int findEdge(int src, int dest) const;
+
+    /**
+     * @brief Performs a Breadth-First Search algorithm.
+     *
+     * @details Goes top-down while the frontier is small and bottom-up, with
+     *          every unvisited node looking for a parent in the frontier,
+     *          while it is large, so dense graphs need far fewer edges
+     *          checked. The path can be retrieved with
+     *          TraversalWorkspace::getParent().
+     *
+     * @param start Starting node
+     * @param end Destination node
+     * @param workspace Where the state of the search is kept
+     */
+    void bfs(int start, int end, TraversalWorkspace &workspace) const;
+
+    /**
+     * @brief Performs a Breadth-First Search from both ends at once, always
+     *        expanding the smallest frontier, until they meet.
+     *
+     * @details The path from the start to the meeting node can be retrieved
+     *          with TraversalWorkspace::getParent() on the forward workspace,
+     *          and the path from the meeting node to the end on the backward
+     *          workspace, where the parent of a node is the next one towards
+     *          the end. Either way, the parent edge is the edge between them.
+     *
+     * @param start Starting node
+     * @param end Destination node
+     * @param forward Where the state of the search from the start is kept
+     * @param backward Where the state of the search from the end is kept
+     * @return The node where both searches met, in a path with the fewest
+     *         edges, or -1 if the end can't be reached
+     */
+    int bidirectionalBfs(int start, int end, TraversalWorkspace &forward,
+                         TraversalWorkspace &backward) const;
+
+    /**
+     * @brief Finds the path with the highest capacity, the capacity of its
+     *        narrowest edge.
+     *
+     * @details A Dijkstra-like search that always expands the node with the
+     *          widest path so far. Uses a BucketQueue with one bucket per
+     *          capacity, unless there are more capacities than nodes and edges
+     *          together, in which case it uses a DaryHeap. The path can be
+     *          retrieved with TraversalWorkspace::getParent().
+     *
+     * @param start Starting node
+     * @param end Destination node
+     * @param workspace Where the state of the search is kept
+     * @return The capacity of the path, or -1 if the end can't be reached
+     */
+    int widestPath(int start, int end, TraversalWorkspace &workspace) const;
+
+    /**
+     * @brief Applies the Edmonds-Karp algorithm to this graph
+     *
+     * @details Runs on a new ResidualNetwork, so it always starts with no
+     *          flow.
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the desired size of a group traveling through this graph
+     * @return std::pair<int, Graph> the flow that was found and the graph made
+     * of the edges that carry it
+     */
+    std::pair<int, Graph> edmondsKarp(int start, int end,
+                                      int groupSize = INT_MAX) const;
+
+    /**
+     * @brief Applies the Dinic algorithm to this graph
+     *
+     * @details Runs on a new ResidualNetwork, so it always starts with no
+     *          flow.
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the desired size of a group traveling through this graph
+     * @return std::pair<int, Graph> the flow that was found and the graph made
+     * of the edges that carry it
+     */
+    std::pair<int, Graph> dinic(int start, int end,
+                                int groupSize = INT_MAX) const;
+
+    /**
+     * @brief Applies the push-relabel algorithm to this graph
+     *
+     * @details Runs on a new ResidualNetwork, so it always starts with no
+     *          flow.
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the desired size of a group traveling through this graph
+     * @return std::pair<int, Graph> the flow that was found and the graph made
+     * of the edges that carry it
+     */
+    std::pair<int, Graph> pushRelabel(int start, int end,
+                                      int groupSize = INT_MAX) const;
+
+    /**
+     * @brief Calculates a flow in this graph with the given algorithm
+     *
+     * @param engine the algorithm to use
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the desired size of a group traveling through this graph
+     * @param work where the work done is added, if it isn't nullptr
+     * @return std::pair<int, Graph> the flow that was found and the graph made
+     * of the edges that carry it
+     */
+    std::pair<int, Graph> maxFlow(FlowEngine engine, int start, int end,
+                                  int groupSize = INT_MAX,
+                                  WorkCounters *work = nullptr) const;
+
+    /**
+     * @brief Exports this graph as a .dot formatted file.
+     *
+     * @details The edges are written straight from the packed edge arrays,
+     *          without copying this graph. Large graphs can be limited to the
+     *          nodes a few hops away from the paths, ignoring the direction of
+     *          the edges, or from the first and last nodes if there are no
+     *          paths. The other nodes are shown as a single summary node, with
+     *          one edge to and from each node that is shown for all of its
+     *          edges to and from them.
+     *
+     * @param path the path to which the file will be exported
+     * @param overlays the paths to highlight over this graph
+     * @param hops how many hops away from the paths nodes are shown, or -1 to
+     * show the whole graph
+     */
+    void toDotFile(const std::string &path,
+                   std::span<const DotOverlay> overlays = {},
+                   int hops = -1) const;
+
+    /**
+     * @brief Creates a mutable copy of this graph.
+     *
+     * @return The graph.
+     */
+    Graph toGraph() const;
+};
+
+#endif // DA_PROJ2_CSR_GRAPH_H
@@ -0,0 +1,88 @@
+#ifndef DA_PROJ2_DARY_HEAP_H
+#define DA_PROJ2_DARY_HEAP_H
+
+class DaryHeap;
+
+#include <vector>
+
+/**
+ * @brief Represents a max priority queue of nodes as a 4-ary heap.
+ *
+ * @details Remembers where each node is in the heap, so a node that is pushed
+ *          again is moved instead of added twice.
+ */
+class DaryHeap {
+    /**
+     * @brief The number of children of each entry of the heap.
+     */
+    static constexpr int ARITY = 4;
+
+    /**
+     * @brief The nodes in the heap.
+     */
+    std::vector<int> heap;
+    /**
+     * @brief Where each node is in the heap, or -1 if it isn't there.
+     */
+    std::vector<int> positions;
+    /**
+     * @brief The key of each node.
+     */
+    std::vector<int> keys;
+
+    /**
+     * @brief Moves an entry up until its parent has a key at least as high.
+     *
+     * @param i The index of the entry.
+     */
+    void siftUp(int i);
+
+    /**
+     * @brief Moves an entry down until its children have keys at most as
+     *        high.
+     *
+     * @param i The index of the entry.
+     */
+    void siftDown(int i);
+
+    /**
+     * @brief Puts a node in an entry of the heap.
+     *
+     * @param i The index of the entry.
+     * @param node The node.
+     */
+    void place(int i, int node) {
+        heap[i] = node;
+        positions[node] = i;
+    }
+
+public:
+    /**
+     * @brief Creates an empty heap.
+     *
+     * @param n The highest node that can be pushed.
+     */
+    explicit DaryHeap(int n);
+
+    /**
+     * @return Whether there are no nodes in the heap.
+     */
+    bool empty() const { return heap.empty(); }
+
+    /**
+     * @brief Adds a node to the heap, or moves it if it is already there.
+     *
+     * @param node The node.
+     * @param key The node's new key, which can't be lower than its old one.
+     */
+    void push(int node, int key);
+
+    /**
+     * @brief Removes a node with the highest key from the heap.
+     *
+     * @return The node.
+     */
+    int pop();
+};
+
+#endif // DA_PROJ2_DARY_HEAP_H
@@ -5,6 +5,7 @@ struct DatasetGenerationParams;
 class Dataset;
 
 #include <climits>
+#include <cstdint>
 #include <iostream>
 #include <list>
 #include <string>
@@ -12,11 +13,39 @@ class Dataset;
 #include <unordered_set>
 #include <vector>
 
+#include "./csr_graph.hpp"
 #include "./graph.hpp"
 #include "./scenarios.hpp"
+#include "./utils.hpp"
 
 #define INF (std::numeric_limits<int>::max() / 2)
 
+/** @brief The shape of the graphs Dataset::generate() generates. */
+enum class Topology {
+    /** @brief Random edges from lower to higher nodes. */
+    UNIFORM,
+    /**
+     * @brief Layers of nodes between the first and the last, with edges from
+     *        each layer to the next.
+     */
+    LAYERED,
+    /**
+     * @brief A grid filled row by row, with edges to the right and down, so
+     *        the number of edges is ignored.
+     */
+    GRID,
+    /**
+     * @brief Random edges between nodes picked with power-law weights, so a few
+     *        nodes have most of the edges.
+     */
+    POWER_LAW,
+    /**
+     * @brief A chain through every node, with narrow rungs from the first node
+     *        and to the last that Edmonds-Karp saturates one at a time.
+     */
+    LONG_CHAIN
+};
+
 /**
  * @brief Parameters to customize how Dataset::generate() generates datasets.
  */
@@ -35,6 +64,13 @@ struct DatasetGenerationParams {
     unsigned int minEdgeDuration;
     /** @brief The maximum duration edges will have. */
     unsigned int maxEdgeDuration;
+
+    /** @brief The shape of the graph. */
+    Topology topology = Topology::UNIFORM;
+    /** @brief The seed of the random generators. */
+    uint64_t seed = 0;
+    /** @brief How many threads generate the graph, or 0 to use every core. */
+    unsigned threads = 0;
 };
 
 /** @brief An enum representing a type of visualization to do on a dataset. */
@@ -76,16 +112,22 @@ class Dataset {
 
     /** @brief How many nodes the graph has. */
     int n = -1;
-    /** @brief The graph associated with this dataset. */
-    Graph graph;
+    /** @brief The graph associated with this dataset, frozen after loading. */
+    CsrGraph graph;
 
     /** @brief The results from running the first scenario. */
     Scenario1Result scenario1Result;
     /** @brief The results from running the second scenario. */
     Scenario2Result scenario2Result;
 
-    /** @brief Creates a dataset with n nodes and the given graph. */
+    /**
+     * @brief Creates a dataset with n nodes and the given graph, freezing it.
+     */
     Dataset(const int n, const Graph &graph);
+    /**
+     * @brief Creates a dataset with n nodes and the given frozen graph.
+     */
+    Dataset(const int n, CsrGraph &&graph);
     /** @brief Creates an empty dataset. */
     Dataset(){};
 
@@ -93,9 +135,15 @@ public:
     /**
      * @brief Get the Graph object associated with this dataset
      *
-     * @return Graph& the Graph object associated with this dataset
+     * @return CsrGraph& the Graph object associated with this dataset
+     */
+    CsrGraph &getGraph() { return graph; }
+    /**
+     * @brief Get the Graph object associated with this dataset
+     *
+     * @return const CsrGraph& the Graph object associated with this dataset
      */
-    Graph &getGraph() { return graph; }
+    const CsrGraph &getGraph() const { return graph; }
 
     /**
      * @brief Get the number of nodes the graph associated with this dataset has
@@ -121,18 +169,44 @@ public:
     /**
      * @brief Loads a dataset from the given path.
      *
+     * @details The file is mapped into memory and parsed in place. Binary
+     *          snapshots, ending in ::SNAPSHOT_EXTENSION, aren't parsed at
+     *          all, their arrays are used straight from the mapped file.
+     *
      * @note The path must be relative to ::DATASETS_PATH.
      *
      * @param path The folder where the dataset is.
      *
+     * @throws ParseError If the file can't be opened, a line of it is
+     *         malformed, or the snapshot is invalid.
+     *
      * @return The dataset that was loaded.
      */
     static Dataset load(const std::string &path);
 
+    /**
+     * @brief Saves a text dataset as a binary snapshot, next to it and with
+     *        the same name, but ending in ::SNAPSHOT_EXTENSION.
+     *
+     * @note The path must be relative to ::DATASETS_PATH.
+     *
+     * @param path The text dataset.
+     *
+     * @throws ParseError If the file can't be opened, or a line of it is
+     *         malformed.
+     *
+     * @return The path of the snapshot, relative to ::DATASETS_PATH, or an
+     *         empty string if it couldn't be saved.
+     */
+    static std::string convert(const std::string &path);
+
     /**
      * @brief Generates a new dataset from pseudo random data and stores it in a
      *        folder.
      *
+     * @details The same parameters always generate the same file, whatever
+     *          the number of threads.
+     *
      * @param name The folder where the dataset will be stored.
      * @param params The parameters given to the random number generators.
      *
@@ -151,9 +225,16 @@ public:
     /**
      * @brief Creates visualizations ou of this dataset's scenarios
      *
+     * @details The whole graph is too large to lay out for large datasets, so
+     *          the views of the whole graph can be limited to the nodes a few
+     *          hops away from the paths, with the rest shown as a summary.
+     *
+     * @param hops How many hops away from the paths nodes are shown, or -1 to
+     *             show the whole graph.
+     *
      * @return std::unordered_map<Visualization, std::string>
      */
-    std::unordered_map<Visualization, std::string> render();
+    std::unordered_map<Visualization, std::string> render(int hops = -1);
 };
 
 #endif
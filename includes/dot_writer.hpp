@@ -0,0 +1,98 @@
+#ifndef DA_PROJ2_DOT_WRITER_H
+#define DA_PROJ2_DOT_WRITER_H
+
+struct DotOverlay;
+class DotWriter;
+
+#include <span>
+#include <string>
+#include <vector>
+
+#include "./buffered_writer.hpp"
+#include "./graph.hpp"
+
+/**
+ * @brief A path to be highlighted over a graph in a dot file.
+ */
+struct DotOverlay {
+    /** @brief The edges of the path. */
+    const Graph &path;
+    /** @brief What the path is called in the legend. */
+    std::string label;
+};
+
+/**
+ * @brief Writes a graph to a dot file as its edges are given, with any number
+ *        of paths highlighted over it.
+ *
+ * @details Each path gets its own color, spread around the color wheel, and an
+ *          edge in more than one path is drawn as parallel lines with each of
+ *          their colors.
+ */
+class DotWriter {
+    /**
+     * @brief The dot file.
+     */
+    BufferedWriter out;
+    /**
+     * @brief The highlighted paths.
+     */
+    std::span<const DotOverlay> overlays;
+    /**
+     * @brief The color of each path.
+     */
+    std::vector<std::string> colors;
+
+public:
+    /**
+     * @brief The node that stands for the nodes that were left out.
+     */
+    static constexpr int SUMMARY_NODE = 0;
+
+    /**
+     * @brief Starts a dot file, with the legend of the paths.
+     *
+     * @param path The path of the dot file.
+     * @param nodeCount How many nodes the graph has.
+     * @param overlays The highlighted paths, which must outlive this writer.
+     */
+    DotWriter(const std::string &path, int nodeCount,
+              std::span<const DotOverlay> overlays = {});
+
+    DotWriter(const DotWriter &) = delete;
+    DotWriter &operator=(const DotWriter &) = delete;
+
+    /**
+     * @brief Ends the dot file.
+     */
+    ~DotWriter();
+
+    /**
+     * @brief Writes an edge, with the colors of the paths it is in.
+     *
+     * @param src The source node.
+     * @param dest The destination node.
+     */
+    void edge(int src, int dest);
+
+    /**
+     * @brief Writes the node that stands for the nodes that were left out.
+     *
+     * @param hiddenNodes How many nodes were left out.
+     * @param hiddenEdges How many edges were left out, counting those to and
+     *                    from the nodes that were kept.
+     */
+    void summary(int hiddenNodes, long long hiddenEdges);
+
+    /**
+     * @brief Writes an edge that stands for the edges between a node and the
+     *        nodes that were left out.
+     *
+     * @param src The source node, or #SUMMARY_NODE.
+     * @param dest The destination node, or #SUMMARY_NODE.
+     * @param count How many edges it stands for.
+     */
+    void summaryEdge(int src, int dest, int count);
+};
+
+#endif // DA_PROJ2_DOT_WRITER_H
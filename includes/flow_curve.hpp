@@ -0,0 +1,174 @@
+#ifndef DA_PROJ2_FLOW_CURVE_H
+#define DA_PROJ2_FLOW_CURVE_H
+
+class FlowCurve;
+
+#include <climits>
+#include <utility>
+#include <vector>
+
+#include "./csr_graph.hpp"
+#include "./graph.hpp"
+#include "./residual_network.hpp"
+#include "./work_counters.hpp"
+
+/**
+ * @brief The flow of a network as a function of the group size, found with a
+ *        single run of a flow algorithm.
+ *
+ * @details Augmenting paths only ever add flow, so the flow after the first k
+ *          paths of a run is the flow the same run would have found if it was
+ *          stopped at that size. Every path is recorded, with the edges it
+ *          goes through and the flow it can carry, so that the flow for any
+ *          group size is the shortest prefix of paths that carries it, with
+ *          the last one cut down to what is still missing. That is exactly
+ *          the flow a run capped at that group size finds.
+ */
+class FlowCurve {
+    /**
+     * @brief An edge an augmenting path goes through.
+     */
+    struct Step {
+        /** @brief The index of the edge in the graph */
+        int edge;
+        /** @brief The source node of the edge */
+        int src;
+        /** @brief Whether the path cancels flow on the edge */
+        bool backward;
+    };
+
+    /**
+     * @brief The graph the flow was found in.
+     */
+    CsrGraph graph;
+    /**
+     * @brief The number of nodes in the graph.
+     */
+    int n = 0;
+    /**
+     * @brief The flow after each augmenting path.
+     */
+    std::vector<int> breakpoints;
+    /**
+     * @brief Where the steps of each augmenting path start in #steps, with
+     *        one more entry for the end of the last path.
+     */
+    std::vector<int> pathOffsets{0};
+    /**
+     * @brief The steps of every augmenting path, in the order they were found.
+     */
+    std::vector<Step> steps;
+    /**
+     * @brief Whether the paths reach the max flow, or the run stopped at the
+     *        limit.
+     */
+    bool complete = false;
+    /**
+     * @brief The work done by the flow algorithm.
+     */
+    WorkCounters workCounters;
+
+    /**
+     * @brief Sends the flow of a group through a residual network.
+     *
+     * @param groupSize The group size, no larger than getFlow().
+     * @param send Called with each step and the flow sent through it.
+     */
+    template <typename F> void replay(int groupSize, F send) const;
+
+    friend class ResidualNetwork;
+
+    /**
+     * @brief Records that an augmenting path goes through an edge (used by
+     *        ResidualNetwork).
+     */
+    void addStep(int edge, int src, bool backward) {
+        steps.push_back({edge, src, backward});
+    }
+
+    /**
+     * @brief Ends the augmenting path being recorded (used by
+     *        ResidualNetwork).
+     *
+     * @param flow The flow the path can carry, even if less was sent.
+     */
+    void endPath(int flow) {
+        breakpoints.push_back(breakpoints.empty() ? flow
+                                                  : breakpoints.back() + flow);
+        pathOffsets.push_back(steps.size());
+    }
+
+public:
+    /**
+     * @brief Creates an empty curve.
+     */
+    FlowCurve(){};
+    /**
+     * @brief Finds the flow from start to end, recording every augmenting
+     *        path.
+     *
+     * @details Push-relabel doesn't augment through paths, so the engine from
+     *          pathEngine() is used instead.
+     *
+     * @param graph The graph.
+     * @param engine The algorithm to use.
+     * @param start The start node.
+     * @param end The end node.
+     * @param limit The largest group size that will be asked for, so that the
+     *              run can stop as soon as it is carried.
+     */
+    FlowCurve(const CsrGraph &graph, FlowEngine engine, int start, int end,
+              int limit = INT_MAX);
+
+    /**
+     * @return The flow after each augmenting path, in increasing order.
+     */
+    const std::vector<int> &getBreakpoints() const { return breakpoints; }
+
+    /**
+     * @return The flow of all the recorded paths, which is the max flow if
+     *         isComplete().
+     */
+    int getFlow() const { return breakpoints.empty() ? 0 : breakpoints.back(); }
+
+    /**
+     * @return Whether the recorded paths reach the max flow, so that no
+     *         larger group can go through.
+     */
+    bool isComplete() const { return complete; }
+
+    /**
+     * @param groupSize The group size.
+     * @return How many augmenting paths are needed to carry the group, or -1
+     *         if the recorded paths can't carry it.
+     */
+    int pathsFor(int groupSize) const;
+
+    /**
+     * @brief Creates a graph with the edges that carry a group.
+     *
+     * @param groupSize The group size.
+     * @return The flow that was sent, which is less than the group size only
+     *         if the recorded paths can't carry it, and the graph, with all
+     *         the nodes of the graph and the original capacity and duration
+     *         of each edge.
+     */
+    std::pair<int, Graph> flowFor(int groupSize) const;
+
+    /**
+     * @brief Creates the residual network of the graph with the flow of a
+     *        group, as a capped run of the flow algorithm leaves it.
+     *
+     * @param groupSize The group size, no larger than getFlow().
+     * @return The network.
+     */
+    ResidualNetwork networkFor(int groupSize) const;
+
+    /**
+     * @return The work done by the flow algorithm, if the project was built
+     *         with WORK_COUNTERS.
+     */
+    const WorkCounters &getWorkCounters() const { return workCounters; }
+};
+
+#endif // DA_PROJ2_FLOW_CURVE_H
@@ -0,0 +1,22 @@
+#ifndef DA_PROJ2_GENERATOR_H
+#define DA_PROJ2_GENERATOR_H
+
+#include <vector>
+
+#include "./csr_graph.hpp"
+#include "./dataset.hpp"
+
+/**
+ * @brief Generates the edges of a dataset.
+ *
+ * @details The edges are generated in fixed chunks, each with its own random
+ *          generator seeded from the seed and the chunk's index, which are
+ *          built in parallel and then joined in order. So the edges only depend
+ *          on the parameters, not on the number of threads.
+ *
+ * @param params The parameters of the dataset.
+ * @return The edges, with no two between the same nodes.
+ */
+std::vector<CsrEdge> generateEdges(const DatasetGenerationParams &params);
+
+#endif // DA_PROJ2_GENERATOR_H
@@ -2,10 +2,12 @@
 #define DA_PROJ2_GRAPH_H
 
 class Graph;
+struct DotOverlay;
 
 #include <climits>
 #include <iostream>
 #include <list>
+#include <span>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
@@ -64,31 +66,6 @@ struct Node {
      * @brief This node's label.
      */
     int label = -1;
-    /**
-     * @brief This node's parent (used in bfs).
-     */
-    int parent = -1;
-
-    /**
-     * @brief Whether this node has been visited (used in bfs).
-     */
-    bool visited = false;
-
-    /**
-     * @brief Helper variable used in scenarios 2.4 and 2.5 to calculate the
-     * maximum wait time.
-     */
-    int minTime = INT_MAX;
-    /**
-     * @brief Helper variable used in scenarios 2.4 and 2.5 to calculate the
-     * maximum wait time.
-     */
-    int maxTime = INT_MIN;
-
-    /**
-     * @brief This node's wait time.
-     */
-    int waitTime = -1;
 
     /**
      * @brief Creates a node with the specified label
@@ -114,19 +91,6 @@ class Graph {
      */
     std::unordered_map<int, Node> nodes;
 
-    /**
-     * @brief The residual graph resulting from performing flux calculations
-     * (related to the Edmonds-Karp algorithm).
-     *
-     */
-    std::vector<std::vector<int>> residualGraph;
-
-    /**
-     * @brief Marks all nodes as unvisited.
-     *
-     */
-    void resetVisits();
-
 public:
     /**
      * @brief Creates an empty graph.
@@ -137,7 +101,7 @@ public:
      *
      * @param n The number of nodes this graph will have.
      */
-    Graph(int n) : residualGraph(n + 1, std::vector<int>(n + 1)) {
+    Graph(int n) {
         for (int i = 1; i <= n; ++i)
             nodes.insert({i, {i}});
     };
@@ -169,6 +133,10 @@ public:
      * @return This graph's nodes.
      */
     std::unordered_map<int, Node> &getNodes() { return nodes; };
+    /**
+     * @return This graph's nodes.
+     */
+    const std::unordered_map<int, Node> &getNodes() const { return nodes; };
     /**
      * @brief Get the node with the specified code.
      *
@@ -177,40 +145,6 @@ public:
      */
     Node &getNode(const int &id) { return nodes.at(id); };
 
-    /**
-     * @brief Performs a Breadth-First Search algorithm.
-     *
-     * @param start Starting node
-     * @param end Destination node
-     * @return the path between <s> and <t> generated by this algorithm and the
-     * maximum capacity of that path
-     */
-    void bfs(int start, int end);
-
-    /**
-     * @brief Applies breadth-first-search to the graph when running the
-     *        Edmonds-Karp algorithm
-     *
-     * @param s Starting node
-     * @param t Destination node
-     * @param parent Array to keep the path
-     * @param residualGraph The residual graph of a dataset
-     *
-     * @return The max flow that is available in the path from s to t
-     */
-    int edmondsKarpBFS(int s, int t);
-
-    /**
-     * @brief Applies the Edmonds-Karp algorithm to this graph
-     *
-     * @param start the start node of the intended path
-     * @param end the end node of the intended path
-     * @param groupSize the desired size of a group traveling through this graph
-     * @return std::pair<int, Graph>
-     */
-    std::pair<int, Graph> edmondsKarp(int start, int end,
-                                      int groupSize = INT_MAX);
-
     /**
      * @brief Checks if an element with the given key exists
      *
@@ -243,11 +177,14 @@ public:
     /**
      * @brief Exports this graph as a .dot formatted file.
      *
+     * @details The edges are sorted, so the same graph always gives the same
+     *          file.
+     *
      * @param path the path to which the file will be exported
-     * @param paths the paths that constitute the various graphs
+     * @param overlays the paths to highlight over this graph
      */
     void toDotFile(const std::string &path,
-                   const std::vector<std::pair<Graph, std::string>> paths = {});
+                   std::span<const DotOverlay> overlays = {}) const;
 };
 
 #endif
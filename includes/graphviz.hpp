@@ -0,0 +1,35 @@
+#ifndef DA_PROJ2_GRAPHVIZ_H
+#define DA_PROJ2_GRAPHVIZ_H
+
+struct RenderJob;
+
+#include <string>
+#include <vector>
+
+/**
+ * @brief A dot file to be laid out into an svg.
+ */
+struct RenderJob {
+    /** @brief The path of the dot file. */
+    std::string dotPath;
+    /** @brief Where the svg is written. */
+    std::string svgPath;
+};
+
+/**
+ * @brief Lays out dot files into svgs with sfdp.
+ *
+ * @details Runs up to the given number of sfdp processes at once, started
+ *          directly and not through a shell. A hash of each dot file is kept
+ *          next to its svg, and dot files with the same hash as the last time
+ *          they were rendered are skipped.
+ *
+ * @param jobs The dot files to lay out.
+ * @param workers How many processes can run at once, or 0 to use every core.
+ *
+ * @return Whether the svg of each job is ready.
+ */
+std::vector<bool> renderDotFiles(const std::vector<RenderJob> &jobs,
+                                 unsigned workers = 0);
+
+#endif // DA_PROJ2_GRAPHVIZ_H
@@ -0,0 +1,53 @@
+#ifndef DA_PROJ2_LATENCY_HISTOGRAM_H
+#define DA_PROJ2_LATENCY_HISTOGRAM_H
+
+class LatencyHistogram;
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+/**
+ * @brief Counts how long requests took, in buckets that double in width.
+ *
+ * @details Bucket b holds the latencies below 2^b microseconds that didn't fit
+ *          in the bucket before it. The counters are atomic, so any number of
+ *          threads can record into the same histogram without a lock.
+ */
+class LatencyHistogram {
+    /**
+     * @brief How many buckets there are, enough for over an hour.
+     */
+    static constexpr int BUCKETS = 33;
+
+    /**
+     * @brief How many latencies fell into each bucket.
+     */
+    std::array<std::atomic<uint64_t>, BUCKETS> counts{};
+
+public:
+    /**
+     * @brief Creates an empty histogram.
+     */
+    LatencyHistogram(){};
+
+    /**
+     * @brief Counts a latency.
+     *
+     * @param latency The latency.
+     */
+    void record(std::chrono::microseconds latency);
+
+    /**
+     * @brief Sums up the latencies that were counted.
+     *
+     * @return How many there were and the upper bound of the bucket with the
+     *         median, the 90th, the 99th percentile and the highest latency,
+     *         as in "n=10 p50<=4us p90<=16us p99<=64us max<=64us".
+     */
+    std::string summary() const;
+};
+
+#endif // DA_PROJ2_LATENCY_HISTOGRAM_H
@@ -0,0 +1,56 @@
+#ifndef DA_PROJ2_MAPPED_FILE_H
+#define DA_PROJ2_MAPPED_FILE_H
+
+class MappedFile;
+
+#include <string>
+#include <string_view>
+
+/**
+ * @brief Represents a file mapped into memory, read-only.
+ *
+ * @details The file is unmapped when this object is destroyed, so the
+ *          contents must not be used after that.
+ */
+class MappedFile {
+    /**
+     * @brief Where the file starts in memory, or nullptr if it isn't mapped.
+     */
+    const char *data = nullptr;
+    /**
+     * @brief The size of the file, in bytes.
+     */
+    size_t size = 0;
+    /**
+     * @brief Whether the file was opened.
+     */
+    bool open = false;
+
+public:
+    /**
+     * @brief Maps a file into memory.
+     *
+     * @details If the file can't be opened, or is empty, nothing is mapped
+     *          and the contents are empty.
+     *
+     * @param path The path of the file.
+     */
+    explicit MappedFile(const std::string &path);
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile();
+
+    /**
+     * @return Whether the file was opened.
+     */
+    bool isOpen() const { return open; }
+
+    /**
+     * @return The contents of the file.
+     */
+    std::string_view getContents() const { return {data, size}; }
+};
+
+#endif // DA_PROJ2_MAPPED_FILE_H
@@ -0,0 +1,64 @@
+#ifndef DA_PROJ2_MEMORY_TRACKER_H
+#define DA_PROJ2_MEMORY_TRACKER_H
+
+class MemoryTracker;
+
+/**
+ * @brief How much memory some code used.
+ *
+ * @details Every value is -1 if the project was built without
+ *          ALLOCATION_TRACKING, and the peak RSS is also -1 if the system
+ *          doesn't report it.
+ */
+struct MemorySample {
+    /** @brief How many bytes were allocated with new */
+    long long allocatedBytes{-1};
+    /** @brief How many times new was called */
+    long long allocations{-1};
+    /** @brief The highest resident set size of the process, in bytes */
+    long long peakRss{-1};
+};
+
+/**
+ * @brief Measures the memory used by the calling thread between two points.
+ *
+ * @details The global operator new is replaced to count, for each thread, how
+ *          many allocations it made and how many bytes it asked for, so memory
+ *          that is freed along the way is counted as well. The peak resident
+ *          set size is read from /proc/self/status, after being reset by
+ *          start() if the kernel allows it, and is shared by the whole process,
+ *          so it is only exact when a single thread is running. That is why
+ *          solveDatasets() uses a single thread when allocations are tracked.
+ */
+class MemoryTracker {
+    /**
+     * @brief How many bytes the calling thread had allocated when start() was
+     *        called.
+     */
+    long long startBytes = 0;
+    /**
+     * @brief How many allocations the calling thread had made when start() was
+     *        called.
+     */
+    long long startAllocations = 0;
+
+public:
+    /**
+     * @brief Creates a tracker that hasn't started.
+     */
+    MemoryTracker(){};
+
+    /**
+     * @brief Starts measuring, resetting the peak resident set size.
+     */
+    void start();
+
+    /**
+     * @brief Stops measuring.
+     *
+     * @return What was used since start() was called.
+     */
+    MemorySample stop() const;
+};
+
+#endif // DA_PROJ2_MEMORY_TRACKER_H
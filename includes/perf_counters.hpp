@@ -0,0 +1,93 @@
+#ifndef DA_PROJ2_PERF_COUNTERS_H
+#define DA_PROJ2_PERF_COUNTERS_H
+
+class PerfCounters;
+
+#include <array>
+
+/**
+ * @brief The hardware counters recorded while some code ran.
+ *
+ * @details A counter is -1 if it couldn't be recorded, because the project was
+ *          built without PERF_COUNTERS, the system doesn't have it or the
+ *          kernel doesn't allow it.
+ */
+struct PerfSample {
+    /** @brief How many CPU cycles were spent */
+    long long cycles{-1};
+    /** @brief How many instructions were retired */
+    long long instructions{-1};
+    /** @brief How many accesses missed the last level cache */
+    long long cacheMisses{-1};
+    /** @brief How many branches were mispredicted */
+    long long branchMisses{-1};
+    /** @brief How many page faults there were */
+    long long pageFaults{-1};
+};
+
+/**
+ * @brief Records hardware counters of the calling thread, with Linux's
+ *        perf_event_open.
+ *
+ * @details The counters are opened once, as a single group, so that they are
+ *          always scheduled together and read with one system call. Only user
+ *          space is counted, which is what an unprivileged process is allowed
+ *          to count by default. If the kernel has to multiplex them with other
+ *          counters, the values are scaled to the whole time they were
+ *          enabled.
+ */
+class PerfCounters {
+    /**
+     * @brief How many counters there are.
+     */
+    static constexpr int COUNTERS = 5;
+
+    /**
+     * @brief The file descriptor of the group leader, or -1 if no counter
+     *        could be opened.
+     */
+    int leader = -1;
+    /**
+     * @brief The file descriptor of each counter, in the order of the fields
+     *        of PerfSample, or -1 if it couldn't be opened.
+     */
+    std::array<int, COUNTERS> fds{};
+    /**
+     * @brief The position of each counter in the group, or -1 if it isn't in
+     *        it.
+     */
+    std::array<int, COUNTERS> positions{};
+    /**
+     * @brief How many counters are in the group.
+     */
+    int opened = 0;
+
+public:
+    /**
+     * @brief Opens the counters for the calling thread.
+     */
+    PerfCounters();
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+    ~PerfCounters();
+
+    /**
+     * @return The counters of the calling thread, opened the first time it
+     *         asks for them.
+     */
+    static PerfCounters &forThisThread();
+
+    /**
+     * @brief Resets the counters and starts counting.
+     */
+    void start();
+
+    /**
+     * @brief Stops counting.
+     *
+     * @return What was counted since start() was called.
+     */
+    PerfSample stop();
+};
+
+#endif // DA_PROJ2_PERF_COUNTERS_H
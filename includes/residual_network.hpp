@@ -0,0 +1,499 @@
+#ifndef DA_PROJ2_RESIDUAL_NETWORK_H
+#define DA_PROJ2_RESIDUAL_NETWORK_H
+
+class ResidualNetwork;
+class FlowCurve;
+
+#include <climits>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "./bitmap.hpp"
+#include "./csr_graph.hpp"
+#include "./graph.hpp"
+#include "./traversal_workspace.hpp"
+#include "./work_counters.hpp"
+
+/**
+ * @brief The algorithms that can be used to calculate flows.
+ */
+enum class FlowEngine {
+    /** @brief Augments through one shortest path at a time. */
+    EDMONDS_KARP,
+    /** @brief Augments through blocking flows in level graphs. */
+    DINIC,
+    /**
+     * @brief Pushes excess from the highest node, with gap and global
+     *        relabeling heuristics.
+     */
+    PUSH_RELABEL
+};
+
+/**
+ * @brief Finds a flow algorithm by the name it is given on the command line.
+ *
+ * @param name edmonds-karp, dinic or push-relabel.
+ * @return The algorithm, or nothing if no algorithm has that name.
+ */
+std::optional<FlowEngine> parseFlowEngine(const std::string &name);
+
+/**
+ * @brief Finds the algorithm whose flow is kept as the path of a group.
+ *
+ * @details Push-relabel finds the same flow value as the other algorithms, but
+ *          spreads it over several times as many edges, which changes the
+ *          times computed from the path. Its paths are found with
+ *          Edmonds-Karp instead, so that they can be compared across engines.
+ *
+ * @param engine The algorithm used to calculate the flow.
+ * @return The algorithm used to find the path.
+ */
+inline FlowEngine pathEngine(FlowEngine engine) {
+    return engine == FlowEngine::PUSH_RELABEL ? FlowEngine::EDMONDS_KARP
+                                              : engine;
+}
+
+/**
+ * @brief Represents the residual network of a CsrGraph, used to calculate
+ *        flows.
+ *
+ * @details Every edge of the graph becomes a forward arc, holding the capacity
+ *          that is still free, paired with a reverse arc, holding the flow that
+ *          can be sent back. The arcs leaving node u are the indices in
+ *          [offsets[u], offsets[u + 1]) of the packed arc arrays, so memory
+ *          scales with the number of edges.
+ */
+class ResidualNetwork {
+    /**
+     * @brief The graph this network was built from.
+     *
+     * @details Copies of a CsrGraph share its arrays, so keeping one is cheap
+     *          and lets this network be kept and copied on its own.
+     */
+    CsrGraph graph;
+
+    /**
+     * @brief The number of nodes in this network.
+     */
+    int n = 0;
+
+    /**
+     * @brief Where the arcs of each node start in the packed arc arrays.
+     *
+     * @details Has n + 2 entries, so that offsets[u + 1] is always the end of
+     *          the arcs of node u.
+     */
+    std::vector<int> offsets;
+    /**
+     * @brief The destination node of each arc.
+     */
+    std::vector<int> heads;
+    /**
+     * @brief The residual capacity of each arc.
+     */
+    std::vector<int> residual;
+    /**
+     * @brief The index of the arc paired with each arc.
+     */
+    std::vector<int> reverse;
+    /**
+     * @brief The edge of the graph each arc comes from, or -1 for reverse arcs.
+     */
+    std::vector<int> edges;
+    /**
+     * @brief The forward arc of each edge of the graph.
+     */
+    std::vector<int> forwardArcs;
+
+    /**
+     * @brief The state of the last bfs, with the arc used to reach each node
+     *        as its parent edge.
+     */
+    TraversalWorkspace workspace;
+
+    /**
+     * @brief The distance of each node to the source, or -1 if it can't be
+     *        reached (used in dinic).
+     */
+    std::vector<int> level;
+    /**
+     * @brief The next arc to try from each node (used in dinic).
+     */
+    std::vector<int> currentArc;
+    /**
+     * @brief The nodes in the last level found (used in dinic).
+     */
+    std::vector<int> frontier;
+    /**
+     * @brief The nodes in the level being found (used in dinic).
+     */
+    std::vector<int> nextFrontier;
+    /**
+     * @brief The nodes in the last level found, while going bottom-up (used in
+     *        dinic).
+     */
+    Bitmap frontierBits;
+    /**
+     * @brief The nodes in the level being found, while going bottom-up (used
+     *        in dinic).
+     */
+    Bitmap nextFrontierBits;
+
+    /**
+     * @brief Builds the level graph when running the Dinic algorithm.
+     *
+     * @details Goes bottom-up, like CsrGraph::bfs(), while the frontier has
+     *          more arcs than the unvisited nodes.
+     *
+     * @param s Starting node
+     * @param t Destination node
+     *
+     * @return Whether t can be reached from s
+     */
+    bool dinicBFS(int s, int t);
+
+    /**
+     * @brief Sends a blocking flow through the level graph when running the
+     *        Dinic algorithm.
+     *
+     * @param s Starting node
+     * @param t Destination node
+     * @param limit the maximum flow to send
+     *
+     * @return The flow that was sent
+     */
+    int dinicBlockingFlow(int s, int t, int limit);
+
+    /**
+     * @brief The height of each node (used in push-relabel).
+     *
+     * @details Nodes that can reach the sink are below n, nodes that can only
+     *          send their excess back to the source are between n and 2n and
+     *          nodes that can't do either are at 2n. The source itself never
+     *          goes above n.
+     */
+    std::vector<int> height;
+    /**
+     * @brief The flow that is stuck in each node (used in push-relabel).
+     */
+    std::vector<int> excess;
+    /**
+     * @brief The first active node with each height (used in push-relabel).
+     */
+    std::vector<int> activeHead;
+    /**
+     * @brief The next active node with the same height as each node (used in
+     *        push-relabel).
+     */
+    std::vector<int> activeNext;
+    /**
+     * @brief The first node with each height below n (used in push-relabel).
+     */
+    std::vector<int> layerHead;
+    /**
+     * @brief The next node with the same height as each node (used in
+     *        push-relabel).
+     */
+    std::vector<int> layerNext;
+    /**
+     * @brief The previous node with the same height as each node (used in
+     *        push-relabel).
+     */
+    std::vector<int> layerPrev;
+    /**
+     * @brief The highest height that may have active nodes (used in
+     *        push-relabel).
+     */
+    int maxActive = -1;
+    /**
+     * @brief The highest height below n that may have nodes (used in
+     *        push-relabel).
+     */
+    int maxLayer = -1;
+    /**
+     * @brief The work done in relabels since the last global relabel (used in
+     *        push-relabel).
+     */
+    long work = 0;
+
+    /**
+     * @brief The work done by every algorithm run on this network.
+     */
+    WorkCounters workCounters;
+
+    /**
+     * @brief Whether the edges whose flow changes are being recorded (used in
+     *        addFlow()).
+     */
+    bool recordingChanges = false;
+    /**
+     * @brief The epoch of the current addFlow() call.
+     */
+    unsigned changeEpoch = 0;
+    /**
+     * @brief The epoch in which the change of each edge was last recorded.
+     */
+    std::vector<unsigned> changeStamps;
+    /**
+     * @brief The edges whose flow changed in the current addFlow() call, with
+     *        the flow they had before it.
+     */
+    std::vector<std::pair<int, int>> changes;
+
+    /**
+     * @brief Records the edge of an arc as changed, if changes are being
+     *        recorded, before flow is sent through the arc.
+     *
+     * @param a The arc
+     */
+    void recordChange(int a) {
+        if (!recordingChanges)
+            return;
+
+        int edge = edges[a] != -1 ? edges[a] : edges[reverse[a]];
+
+        if (changeStamps[edge] != changeEpoch) {
+            changeStamps[edge] = changeEpoch;
+            changes.emplace_back(edge, getFlow(edge));
+        }
+    }
+
+    /**
+     * @brief Where the augmenting paths are recorded, or nullptr if they
+     *        aren't (used in recordFlow()).
+     */
+    FlowCurve *curve = nullptr;
+
+    /**
+     * @brief Records that the augmenting path being sent goes through an arc,
+     *        which must only be called while #curve is set.
+     *
+     * @param a The arc
+     */
+    void recordStep(int a);
+
+    /**
+     * @brief Checks if a node has excess it can still push.
+     *
+     * @param v The node
+     * @param s Starting node
+     * @param t Destination node
+     *
+     * @return Whether the node is active
+     */
+    bool isActive(int v, int s, int t) const {
+        return v != t && excess[v] > 0 && height[v] < 2 * n &&
+               (v != s || height[v] < n);
+    }
+
+    /**
+     * @brief Adds a node to the active nodes with its height.
+     *
+     * @param v The node
+     */
+    void activate(int v);
+
+    /**
+     * @brief Adds a node to the nodes with its height, which must be below n.
+     *
+     * @param v The node
+     */
+    void addToLayer(int v);
+
+    /**
+     * @brief Removes a node from the nodes with its height, which must be
+     *        below n.
+     *
+     * @param v The node
+     */
+    void removeFromLayer(int v);
+
+    /**
+     * @brief Sets the height of every node to its distance to the sink, or to
+     *        n plus its distance to the source if it can't reach the sink.
+     *
+     * @param s Starting node
+     * @param t Destination node
+     */
+    void globalRelabel(int s, int t);
+
+    /**
+     * @brief Lifts a node just above its lowest neighbour in the residual
+     *        network.
+     *
+     * @details If that leaves no node with its old height, every node above it
+     *          is cut from the sink and is lifted to n (gap heuristic).
+     *
+     * @param v The node
+     * @param s Starting node
+     * @param t Destination node
+     */
+    void relabel(int v, int s, int t);
+
+    /**
+     * @brief Pushes the excess of a node to its neighbours, relabeling it as
+     *        needed, until it isn't active anymore.
+     *
+     * @param v The node
+     * @param s Starting node
+     * @param t Destination node
+     */
+    void discharge(int v, int s, int t);
+
+public:
+    /**
+     * @brief Creates an empty network.
+     */
+    ResidualNetwork(){};
+    /**
+     * @brief Creates the residual network of a graph with no flow.
+     *
+     * @param graph The graph.
+     */
+    explicit ResidualNetwork(const CsrGraph &graph);
+
+    /**
+     * @brief Applies breadth-first-search to the residual network when running
+     *        the Edmonds-Karp algorithm
+     *
+     * @details Walks both the forward and the reverse arcs, the path can be
+     *          retrieved from #workspace.
+     *
+     * @param s Starting node
+     * @param t Destination node
+     *
+     * @return The max flow that is available in the path from s to t, or -1 if
+     *         there is no such path
+     */
+    int edmondsKarpBFS(int s, int t);
+
+    /**
+     * @brief Applies the Edmonds-Karp algorithm to this network, adding to the
+     *        flow already in it
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the maximum flow to add
+     * @return The flow that was added.
+     */
+    int edmondsKarp(int start, int end, int groupSize = INT_MAX);
+
+    /**
+     * @brief Applies the Dinic algorithm to this network, adding to the flow
+     *        already in it
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the maximum flow to add
+     * @return The flow that was added.
+     */
+    int dinic(int start, int end, int groupSize = INT_MAX);
+
+    /**
+     * @brief Applies the highest label push-relabel algorithm to this network,
+     *        adding to the flow already in it
+     *
+     * @details The source starts with the group as excess, so that no more
+     *          than the group is sent and what can't reach the end stays
+     *          there.
+     *
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the maximum flow to add
+     * @return The flow that was added.
+     */
+    int pushRelabel(int start, int end, int groupSize = INT_MAX);
+
+    /**
+     * @brief Adds flow to this network with the given algorithm.
+     *
+     * @param engine the algorithm to use
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the maximum flow to add
+     * @return The flow that was added.
+     */
+    int maxFlow(FlowEngine engine, int start, int end, int groupSize = INT_MAX);
+
+    /**
+     * @brief Adds flow to this network like maxFlow(), recording every
+     *        augmenting path in a curve.
+     *
+     * @details Push-relabel doesn't augment through paths, so the engine from
+     *          pathEngine() is used instead. Each path is recorded with the
+     *          flow it can carry, even if the last one sends less so as not to
+     *          go over the group size.
+     *
+     * @param engine the algorithm to use
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param groupSize the maximum flow to add
+     * @param curve where the paths are recorded
+     * @return The flow that was added.
+     */
+    int recordFlow(FlowEngine engine, int start, int end, int groupSize,
+                   FlowCurve &curve);
+
+    /**
+     * @param edge The index of an edge of the graph.
+     * @return The flow going through that edge.
+     */
+    int getFlow(int edge) const {
+        return graph.getCapacity(edge) - residual[forwardArcs[edge]];
+    }
+
+    /**
+     * @brief Sends flow through an edge, to give this network a flow that was
+     *        found somewhere else.
+     *
+     * @note The flow isn't checked, it is up to the caller to keep it valid.
+     *
+     * @param edge The index of an edge of the graph.
+     * @param flow How much flow to add to that edge.
+     */
+    void sendFlow(int edge, int flow) {
+        residual[forwardArcs[edge]] -= flow;
+        residual[reverse[forwardArcs[edge]]] += flow;
+    }
+
+    /**
+     * @brief Adds flow to this network with the given algorithm, on top of the
+     *        flow it already carries.
+     *
+     * @details Only the edges whose flow changes are looked at afterwards, so
+     *          the cost grows with the flow that is added, not with the flow
+     *          that was there before.
+     *
+     * @param engine the algorithm to use
+     * @param start the start node of the intended path
+     * @param end the end node of the intended path
+     * @param amount the maximum flow to add
+     * @return The flow that was added and the graph made of the edges whose
+     *         flow went up, with their original capacity and duration.
+     */
+    std::pair<int, Graph> addFlow(FlowEngine engine, int start, int end,
+                                  int amount);
+
+    /**
+     * @brief Forgets the work counted so far.
+     */
+    void clearWorkCounters() { workCounters = {}; }
+
+    /**
+     * @return The work done by every algorithm run on this network, if the
+     *         project was built with WORK_COUNTERS.
+     */
+    const WorkCounters &getWorkCounters() const { return workCounters; }
+
+    /**
+     * @brief Creates a graph with the edges that carry flow.
+     *
+     * @return The graph, with all the nodes of the network and the original
+     *         capacity and duration of each edge.
+     */
+    Graph toGraph() const;
+};
+
+#endif // DA_PROJ2_RESIDUAL_NETWORK_H
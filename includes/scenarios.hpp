@@ -2,10 +2,18 @@
 #define DA_PROJ2_SCENARIOS_HPP
 
 #include <chrono>
+#include <functional>
+#include <memory>
+#include <string>
 #include <vector>
 
+#include "flow_curve.hpp"
 #include "graph.hpp"
+#include "memory_tracker.hpp"
+#include "perf_counters.hpp"
+#include "residual_network.hpp"
 #include "utils.hpp"
+#include "work_counters.hpp"
 
 /**
  * @brief Data structure holding result values from running simulations related
@@ -14,6 +22,12 @@
 struct Scenario1Result {
     /** @brief How much time scenario 1.1 took to run */
     std::chrono::microseconds runtime1_1{0};
+    /** @brief The hardware counters recorded while scenario 1.1 ran */
+    PerfSample counters1_1{};
+    /** @brief The memory used while scenario 1.1 ran */
+    MemorySample memory1_1{};
+    /** @brief The work done by the algorithms of scenario 1.1 */
+    WorkCounters work1_1{};
     /** @brief The capacity of the path from scenario 1.1 */
     int capacity1_1{-1};
     /** @brief The number of edges in the path from scenario 1.1 */
@@ -23,6 +37,12 @@ struct Scenario1Result {
 
     /** @brief How much time scenario 1.2 took to run */
     std::chrono::microseconds runtime1_2{0};
+    /** @brief The hardware counters recorded while scenario 1.2 ran */
+    PerfSample counters1_2{};
+    /** @brief The memory used while scenario 1.2 ran */
+    MemorySample memory1_2{};
+    /** @brief The work done by the algorithms of scenario 1.2 */
+    WorkCounters work1_2{};
     /** @brief The capacity of the path from scenario 1.2 */
     int capacity1_2{-1};
     /** @brief The number of edges in the path from scenario 1.2 */
@@ -38,22 +58,53 @@ struct Scenario1Result {
 struct Scenario2Result {
     /** @brief How much time scenario 2.1 took to run */
     std::chrono::microseconds runtime2_1{0};
+    /** @brief The hardware counters recorded while scenario 2.1 ran */
+    PerfSample counters2_1{};
+    /** @brief The memory used while scenario 2.1 ran */
+    MemorySample memory2_1{};
+    /** @brief The work done by the algorithms of scenario 2.1 */
+    WorkCounters work2_1{};
     /** @brief The group size in scenario 2.1 */
     int groupSize2_1{-1};
     /** @brief The path from scenario 2.1 */
     Graph path2_1{};
+    /**
+     * @brief The residual network with the flow of scenario 2.1, which
+     * scenario 2.2 resumes from
+     */
+    std::shared_ptr<const ResidualNetwork> network2_1{};
+    /**
+     * @brief The flow curve scenario 2.1 was answered from, if it was run for
+     * several group sizes, in which case scenario 2.2 rebuilds the network
+     * from it
+     */
+    std::shared_ptr<const FlowCurve> curve2_1{};
 
     /** @brief How much time scenario 2.2 took to run */
     std::chrono::microseconds runtime2_2{0};
+    /** @brief The hardware counters recorded while scenario 2.2 ran */
+    PerfSample counters2_2{};
+    /** @brief The memory used while scenario 2.2 ran */
+    MemorySample memory2_2{};
+    /** @brief The work done by the algorithms of scenario 2.2 */
+    WorkCounters work2_2{};
     /** @brief The increase in group size in scenario 2.2 */
     int increase2_2{-1};
     /** @brief Whether the increase in group size in scenario 2.2 requires a new path */
     bool requiresNewPath2_2{false};
     /** @brief The path from scenario 2.2 */
     Graph path2_2{};
+    /** @brief The edges whose flow went up in scenario 2.2 */
+    Graph delta2_2{};
 
     /** @brief How much time scenario 2.3 took to run */
     std::chrono::microseconds runtime2_3{0};
+    /** @brief The hardware counters recorded while scenario 2.3 ran */
+    PerfSample counters2_3{};
+    /** @brief The memory used while scenario 2.3 ran */
+    MemorySample memory2_3{};
+    /** @brief The work done by the algorithms of scenario 2.3 */
+    WorkCounters work2_3{};
     /** @brief The flow of path from scenario 2.3 */
     int maxFlow2_3{-1};
     /** @brief The path from scenario 2.3 */
@@ -61,11 +112,19 @@ struct Scenario2Result {
 
     /** @brief How much time scenario 2.4 took to run */
     std::chrono::microseconds runtime2_4{0};
+    /** @brief The hardware counters recorded while scenario 2.4 ran */
+    PerfSample counters2_4{};
+    /** @brief The memory used while scenario 2.4 ran */
+    MemorySample memory2_4{};
     /** @brief The earliest possible finishing time calculated in scenario 2.4 */
     int earliestFinish2_4{-1};
 
     /** @brief How much time scenario 2.5 took to run */
     std::chrono::microseconds runtime2_5{0};
+    /** @brief The hardware counters recorded while scenario 2.5 ran */
+    PerfSample counters2_5{};
+    /** @brief The memory used while scenario 2.5 ran */
+    MemorySample memory2_5{};
     /** @brief The maximum waiting time calculated in scenario 2.4 */
     int maxWaitTime2_5{-1};
     /** @brief The nodes where the waiting time is the maximum */
@@ -74,11 +133,62 @@ struct Scenario2Result {
 
 /**
  * @brief Runs all scenarios, using all the available datasets.
+ *
+ * @details Scenarios 2.1 to 2.3 are also timed with the Dinic and the
+ *          push-relabel algorithms, but the results that are kept come from
+ *          Edmonds-Karp.
+ *
+ *          Datasets are solved concurrently by the given number of threads,
+ *          each timing its own scenarios, but the results are still written
+ *          in the same order as Dataset::getAvailableDatasets().
+ *
+ * @param groupSize The group size used in scenarios 2.1 and 2.2.
+ * @param increase The group size increase used in scenario 2.2.
+ * @param threads How many datasets to solve at once, or 0 to use every core.
  */
-void runAllScenarios(int groupSize, int increase);
+void runAllScenarios(int groupSize, int increase, unsigned threads = 1);
 
 #include "dataset.hpp"
 
+/**
+ * @brief Calculates the earliest start of every node of a path graph, by going
+ * through it in topological order.
+ *
+ * @param graph The path graph.
+ * @param earliestStart Where the earliest start of each node will be stored,
+ * which is also the latest arrival at that node.
+ * @param earliestArrival Where the earliest arrival at each node will be
+ * stored, or INT_MAX if no edge reaches that node.
+ *
+ * @return The earliest time at which the whole group can finish.
+ */
+int earliestStartTimes(const CsrGraph &graph, std::vector<int> &earliestStart,
+                       std::vector<int> &earliestArrival);
+
+/**
+ * @brief Loads and solves datasets on several threads, handing the results
+ *        over in the order the datasets were given.
+ *
+ * @details A dataset that doesn't exist, can't be parsed or can't be solved
+ *          because of an exception is reported on std::cerr and skipped.
+ *
+ *          If the project was built with ALLOCATION_TRACKING, datasets are
+ *          solved one at a time, so that the peak RSS of each scenario isn't
+ *          mixed with the others.
+ *
+ * @param names The datasets, from the ::DATASETS_PATH.
+ * @param threads How many datasets to solve at once, or 0 to use every core.
+ * @param solve Solves a dataset, given its name, and returns what to write.
+ * @param write Called with what was returned for each dataset, in order, from
+ *              the calling thread.
+ *
+ * @return Whether every dataset could be solved.
+ */
+bool solveDatasets(
+    const std::vector<std::string> &names, unsigned threads,
+    const std::function<std::string(const std::string &, Dataset &)> &solve,
+    const std::function<void(const std::string &)> &write);
+
 /**
  * @brief Maximizes the group dimension and picks any path
  *
@@ -104,29 +214,70 @@ void scenario1_2(Dataset &dataset);
  * @brief Calculates a path for a given group to use, given the group's size
  *
  * @param dataset The graph in which the algorithm is performed
+ * @param groupSize The size of the group
+ * @param engine The algorithm used to calculate the flow
  *
  * @return ScenarioResult The path for the group
  */
-void scenario2_1(Dataset &dataset, int groupSize);
+void scenario2_1(Dataset &dataset, int groupSize,
+                 FlowEngine engine = FlowEngine::EDMONDS_KARP);
+
+/**
+ * @brief Runs scenario 2.1 for several group sizes, with a single run of the
+ *        flow algorithm
+ *
+ * @details Records the flow curve up to the largest group size, and answers
+ *          every group size from it, with the same path scenario2_1() would
+ *          find. The cost of recording the curve is counted in the result of
+ *          the first group size, the others only count their own paths.
+ *
+ *          A single group size has nothing to share, and push-relabel
+ *          doesn't augment through paths, so in those cases every group size
+ *          is run on its own with scenario2_1(), and the engine is always the
+ *          one that was asked for.
+ *
+ *          Only the fields of scenario 2.1 are set, the others are copied
+ *          from the dataset, and the result of the last group size is left in
+ *          the dataset.
+ *
+ * @param dataset The graph in which the algorithm is performed
+ * @param groupSizes The sizes of the groups
+ * @param engine The algorithm used to calculate the flow
+ *
+ * @return The result of scenario 2.1 for each group size, in the same order
+ */
+std::vector<Scenario2Result>
+scenario2_1Sweep(Dataset &dataset, const std::vector<int> &groupSizes,
+                 FlowEngine engine = FlowEngine::EDMONDS_KARP);
 
 /**
  * @brief Calculates a new path for a group with an increased given size
  *
+ * @details Resumes from the flow of scenario 2.1, which must have found a
+ *          path, so only the increase is sent. It is first sent through the
+ *          edges of the path from scenario 2.1, and only through the whole
+ *          graph if they can't carry it.
+ *
  * @param dataset The graph in which the algorithm is performed
+ * @param increase How much the group grows
+ * @param engine The algorithm used to calculate the flow
  *
  * @return ScenarioResult The new path for the group
  */
-void scenario2_2(Dataset &dataset, int increase);
+void scenario2_2(Dataset &dataset, int increase,
+                 FlowEngine engine = FlowEngine::EDMONDS_KARP);
 
 /**
  * @brief Calculates the maximum size of a group and calculates the path
  *
  * @param dataset The graph in which the algorithm is performed
+ * @param engine The algorithm used to calculate the flow
  *
  * @return ScenarioResult The maximum number of elements of the group and a path
  * available for them
  */
-void scenario2_3(Dataset &dataset);
+void scenario2_3(Dataset &dataset,
+                 FlowEngine engine = FlowEngine::EDMONDS_KARP);
 
 /**
  * @brief Calculates at what time after departure the group will meet in the
@@ -137,7 +288,7 @@ void scenario2_3(Dataset &dataset);
  * @return ScenarioResult The minimum time at which the group meets in the
  * destination
  */
-void scenario2_4(Dataset &dataset, Graph &graph);
+void scenario2_4(Dataset &dataset, const Graph &graph);
 
 /**
  * @brief Calculates the maximum time some elements of the group wait for the
@@ -148,6 +299,6 @@ void scenario2_4(Dataset &dataset, Graph &graph);
  * @return ScenarioResult The maximum time some elements of the group wait and
  * their locations
  */
-void scenario2_5(Dataset &dataset, Graph &graph);
+void scenario2_5(Dataset &dataset, const Graph &graph);
 
 #endif
@@ -0,0 +1,49 @@
+#ifndef DA_PROJ2_SERVER_H
+#define DA_PROJ2_SERVER_H
+
+/**
+ * @brief Loads datasets once and answers queries about them, one per line,
+ *        until the input ends or the server is stopped.
+ *
+ * @details Takes `--serve`, then the datasets to load, or every available
+ *          dataset if none are given, and these options:
+ *
+ *          - `-s, --socket PATH`: listens on a Unix domain socket, answering
+ *            each client on its own thread, instead of reading the standard
+ *            input.
+ *          - `-e, --engine NAME`: the flow algorithm, edmonds-karp (the
+ *            default), dinic or push-relabel.
+ *
+ *          Each query is answered with a line starting with `ok`, followed by
+ *          the results, or with `error` and what went wrong:
+ *
+ *          - `widest DATASET SOURCE SINK`: the capacity and the connections of
+ *            the path with the highest capacity, as in scenario 1.1.
+ *          - `hops DATASET SOURCE SINK`: the capacity and the connections of a
+ *            path with the fewest connections, as in scenario 1.2.
+ *          - `flow DATASET SOURCE SINK GROUP_SIZE`: how much of the group can
+ *            travel together, as in scenario 2.1.
+ *          - `maxflow DATASET SOURCE SINK`: the largest group that can travel,
+ *            as in scenario 2.3.
+ *          - `earliest DATASET SOURCE SINK`: when the largest group can all
+ *            arrive, as in scenario 2.4.
+ *          - `maxwait DATASET SOURCE SINK`: the longest wait of the largest
+ *            group and the nodes where it waits, as in scenario 2.5.
+ *          - `datasets`: the loaded datasets.
+ *          - `stats`: a histogram summary of how long each query took.
+ *          - `quit`: ends the connection.
+ *
+ *          A path that doesn't exist has -1 for its values. The latencies are
+ *          also written to the standard error when the server stops, on the
+ *          end of the input or on SIGINT or SIGTERM.
+ *
+ * @param argc The number of arguments, including the program's name.
+ * @param argv The arguments.
+ *
+ * @return The exit status: 0 if the server ran and stopped, 1 if a dataset
+ *         couldn't be loaded or the socket couldn't be opened, and 2 if the
+ *         arguments are invalid.
+ */
+int runServer(int argc, char **argv);
+
+#endif // DA_PROJ2_SERVER_H
@@ -0,0 +1,122 @@
+#ifndef DA_PROJ2_TRACER_H
+#define DA_PROJ2_TRACER_H
+
+class Tracer;
+class TraceSpan;
+
+#include <atomic>
+#include <string>
+
+/**
+ * @brief Records spans of time in a timeline that can be opened in
+ *        chrome://tracing or Perfetto.
+ *
+ * @details Each thread writes its spans to its own ring buffer, which only it
+ *          writes to, so recording never takes a lock. When a buffer is full
+ *          the oldest spans are overwritten. The buffers outlive their
+ *          threads and are written as Chrome trace-event JSON when the
+ *          program exits.
+ *
+ *          Tracing is off until enable() is called, and then costs two clock
+ *          reads and a store per span.
+ */
+class Tracer {
+    /**
+     * @brief Whether spans are being recorded.
+     */
+    static inline std::atomic<bool> active{false};
+
+public:
+    /**
+     * @brief Starts recording spans.
+     *
+     * @details Can only be called once, any other call is ignored.
+     *
+     * @param path Where the trace will be written when the program exits.
+     */
+    static void enable(const std::string &path);
+
+    /**
+     * @return Whether spans are being recorded.
+     */
+    static bool isEnabled() { return active.load(std::memory_order_relaxed); }
+
+    /**
+     * @return The current time in nanoseconds, from a steady clock.
+     */
+    static long long now();
+
+    /**
+     * @brief Records a span on the calling thread.
+     *
+     * @param name The name of the span, which must live until the program
+     *             exits, like a string literal.
+     * @param start When it started, from now().
+     * @param end When it ended, from now().
+     * @param argName The name of a value to show with the span, which must
+     *                also live until the program exits, or nullptr if there
+     *                is none.
+     * @param arg The value to show with the span.
+     */
+    static void record(const char *name, long long start, long long end,
+                       const char *argName = nullptr, long long arg = 0);
+
+    /**
+     * @brief Writes every span recorded so far to the path given to enable().
+     *
+     * @details Called when the program exits, so it doesn't have to be called
+     *          by hand.
+     */
+    static void flush();
+};
+
+/**
+ * @brief Records a span from its creation until the end of its scope, if
+ *        tracing is enabled.
+ */
+class TraceSpan {
+    /**
+     * @brief The name of the span.
+     */
+    const char *name;
+    /**
+     * @brief The name of the value shown with the span, or nullptr.
+     */
+    const char *argName;
+    /**
+     * @brief The value shown with the span.
+     */
+    long long arg;
+    /**
+     * @brief When the span started, or -1 if tracing wasn't enabled.
+     */
+    long long start = -1;
+
+public:
+    /**
+     * @brief Starts a span.
+     *
+     * @param name The name of the span, like a string literal.
+     * @param argName The name of a value to show with the span, like a string
+     *                literal, or nullptr if there is none.
+     * @param arg The value to show with the span.
+     */
+    explicit TraceSpan(const char *name, const char *argName = nullptr,
+                       long long arg = 0)
+        : name(name), argName(argName), arg(arg) {
+        if (Tracer::isEnabled())
+            start = Tracer::now();
+    }
+    TraceSpan(const TraceSpan &) = delete;
+    TraceSpan &operator=(const TraceSpan &) = delete;
+
+    /**
+     * @brief Ends the span.
+     */
+    ~TraceSpan() {
+        if (start != -1)
+            Tracer::record(name, start, Tracer::now(), argName, arg);
+    }
+};
+
+#endif // DA_PROJ2_TRACER_H
@@ -0,0 +1,97 @@
+#ifndef DA_PROJ2_TRAVERSAL_WORKSPACE_H
+#define DA_PROJ2_TRAVERSAL_WORKSPACE_H
+
+class TraversalWorkspace;
+
+#include <vector>
+
+#include "./work_counters.hpp"
+
+/**
+ * @brief Holds the state of a traversal of a graph, so that the graph itself
+ *        doesn't have to change while it is being searched.
+ *
+ * @details A node counts as visited only if its stamp matches the current
+ *          epoch, so starting a new traversal just moves to the next epoch
+ *          instead of clearing every node.
+ *
+ * @note The parent of a node is only meaningful if it was visited in the
+ *       current traversal.
+ */
+class TraversalWorkspace {
+    /**
+     * @brief The epoch of the current traversal.
+     */
+    unsigned epoch = 0;
+
+    /**
+     * @brief The epoch in which each node was last visited.
+     */
+    std::vector<unsigned> stamps;
+    /**
+     * @brief The node each node was reached from.
+     */
+    std::vector<int> parents;
+    /**
+     * @brief The edge used to reach each node.
+     */
+    std::vector<int> parentEdges;
+
+    /**
+     * @brief The work done by every traversal that used this workspace.
+     */
+    WorkCounters workCounters;
+
+public:
+    /**
+     * @brief Creates an empty workspace.
+     */
+    TraversalWorkspace(){};
+
+    /**
+     * @brief Starts a new traversal, with no node visited.
+     *
+     * @details Only grows the workspace if it has less than n + 1 entries.
+     *
+     * @param n The highest label of the nodes that will be visited.
+     */
+    void reset(int n);
+
+    /**
+     * @brief Marks a node as visited in the current traversal.
+     *
+     * @param node The node.
+     * @param parent The node it was reached from.
+     * @param edge The edge used to reach it.
+     */
+    void visit(int node, int parent = -1, int edge = -1) {
+        stamps[node] = epoch;
+        parents[node] = parent;
+        parentEdges[node] = edge;
+    }
+
+    /**
+     * @param node The node.
+     * @return Whether the given node was visited in the current traversal.
+     */
+    bool isVisited(int node) const { return stamps[node] == epoch; }
+
+    /**
+     * @param node The node.
+     * @return The node the given node was reached from.
+     */
+    int getParent(int node) const { return parents[node]; }
+    /**
+     * @param node The node.
+     * @return The edge used to reach the given node.
+     */
+    int getParentEdge(int node) const { return parentEdges[node]; }
+
+    /**
+     * @return The work done by every traversal that used this workspace, if
+     *         the project was built with WORK_COUNTERS.
+     */
+    WorkCounters &getWorkCounters() { return workCounters; }
+};
+
+#endif // DA_PROJ2_TRAVERSAL_WORKSPACE_H
@@ -23,6 +23,10 @@ enum class Menu {
     CHOOSE_DATASET,
     /** @brief Allows the user to generate a new dataset. */
     GENERATE_DATASET,
+    /** @brief Allows the user to save a dataset as a binary snapshot. */
+    CONVERT_DATASET,
+    /** @brief Allows the user to choose which algorithm calculates flows. */
+    CHOOSE_FLOW_ENGINE,
 
     /** @brief Renders the dataset visualizations. */
     RENDER_VISUALIZATIONS,
@@ -84,6 +88,11 @@ class UserInterface {
      */
     std::unordered_map<Visualization, std::string> visualizations{};
 
+    /**
+     * @brief The algorithm used to calculate flows in scenarios 2.1 to 2.3.
+     */
+    FlowEngine flowEngine{FlowEngine::EDMONDS_KARP};
+
     /**
      * @brief Helper method to show a menu with options.
      *
@@ -210,6 +219,16 @@ class UserInterface {
      */
     void generateDatasetMenu(Dataset &dataset);
 
+    /**
+     * @brief Allows the user to save a text dataset as a binary snapshot.
+     */
+    void convertDatasetMenu();
+
+    /**
+     * @brief Allows the user to choose which algorithm calculates flows.
+     */
+    void chooseFlowEngineMenu();
+
     /**
      * @brief Runs scenario 1.
      *
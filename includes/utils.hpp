@@ -1,6 +1,7 @@
 #ifndef DA_PROJ2_UTILS_H
 #define DA_PROJ2_UTILS_H
 
+#include <stdexcept>
 #include <string>
 #include <vector>
 
@@ -9,6 +10,17 @@
  */
 class Exit {};
 
+/**
+ * @brief Exception thrown when a dataset file is malformed.
+ *
+ * @details The message starts with the file, and the line if it is a text
+ *          file, where the problem was found.
+ */
+class ParseError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
 /**
  * @brief Splits a string by a character.
  *
@@ -0,0 +1,80 @@
+#ifndef DA_PROJ2_WORK_COUNTERS_H
+#define DA_PROJ2_WORK_COUNTERS_H
+
+struct WorkCounters;
+
+#include <array>
+#include <string>
+
+/**
+ * @brief Runs a statement that counts work, only if the project was built with
+ *        WORK_COUNTERS, so that the counting is compiled out otherwise.
+ */
+#ifdef WORK_COUNTERS
+#define COUNT_WORK(statement) statement
+#else
+#define COUNT_WORK(statement)
+#endif
+
+/**
+ * @brief The names of the work counters, in the order of
+ *        WorkCounters::values().
+ */
+const std::array<std::string, 8> WORK_COUNTER_NAMES{
+    "augmentingPaths", "bfsPasses", "nodesDequeued",   "arcsScanned",
+    "pushes",          "relabels",  "minAugmentation", "maxAugmentation"};
+
+/**
+ * @brief How much work a traversal or a flow algorithm did, to explain its
+ *        runtime.
+ *
+ * @details Only counted if the project was built with WORK_COUNTERS.
+ */
+struct WorkCounters {
+    /** @brief How many augmenting paths were found */
+    long long augmentingPaths{0};
+    /** @brief How many breadth-first searches were made */
+    long long bfsPasses{0};
+    /** @brief How many nodes were taken from a queue or a frontier */
+    long long nodesDequeued{0};
+    /** @brief How many arcs were looked at */
+    long long arcsScanned{0};
+    /** @brief How many pushes push-relabel made */
+    long long pushes{0};
+    /** @brief How many relabels push-relabel made */
+    long long relabels{0};
+    /** @brief The least flow sent through an augmenting path, or -1 if none */
+    long long minAugmentation{-1};
+    /** @brief The most flow sent through an augmenting path */
+    long long maxAugmentation{0};
+
+    /**
+     * @brief Counts an augmenting path.
+     *
+     * @param flow The flow sent through it.
+     */
+    void augment(long long flow) {
+        ++augmentingPaths;
+
+        if (minAugmentation == -1 || flow < minAugmentation)
+            minAugmentation = flow;
+        if (flow > maxAugmentation)
+            maxAugmentation = flow;
+    }
+
+    /**
+     * @brief Adds the work counted by someone else to this.
+     *
+     * @param other The other counters.
+     * @return These counters.
+     */
+    WorkCounters &operator+=(const WorkCounters &other);
+
+    /**
+     * @return The counters, in the order of ::WORK_COUNTER_NAMES, or all -1
+     *         if the project was built without WORK_COUNTERS.
+     */
+    std::array<long long, 8> values() const;
+};
+
+#endif // DA_PROJ2_WORK_COUNTERS_H
@@ -0,0 +1,422 @@
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <utility>
+#include <vector>
+
+#include "../includes/batch.hpp"
+#include "../includes/constants.hpp"
+#include "../includes/scenarios.hpp"
+#include "../includes/utils.hpp"
+
+/**
+ * @brief Adds the columns of the work counters of a scenario, if the project
+ *        was built with WORK_COUNTERS.
+ *
+ * @param columns The other columns of the scenario.
+ * @param suffix The suffix of the columns of the scenario, like "1_1".
+ */
+static std::vector<std::string>
+withWork(std::vector<std::string> columns,
+         [[maybe_unused]] const std::string &suffix) {
+#ifdef WORK_COUNTERS
+    for (const std::string &name : WORK_COUNTER_NAMES)
+        columns.push_back(name + suffix);
+#endif
+
+    return columns;
+}
+
+/**
+ * @brief Adds the values of the work counters of a scenario, if the project
+ *        was built with WORK_COUNTERS.
+ */
+static void addWork([[maybe_unused]] std::vector<long long> &values,
+                    [[maybe_unused]] const WorkCounters &work) {
+#ifdef WORK_COUNTERS
+    auto counters = work.values();
+    values.insert(values.end(), counters.begin(), counters.end());
+#endif
+}
+
+/**
+ * @brief The scenarios that can be run, in the order they are run, with the
+ *        columns of their results, named like in ::OUTPUT_HEADER.
+ */
+static const std::vector<std::pair<std::string, std::vector<std::string>>>
+    SCENARIOS{
+        {"1.1",
+         withWork({"capacity1_1", "connections1_1", "runtime1_1"}, "1_1")},
+        {"1.2",
+         withWork({"capacity1_2", "connections1_2", "runtime1_2"}, "1_2")},
+        {"2.1", withWork({"groupSize2_1", "runtime2_1"}, "2_1")},
+        {"2.2",
+         withWork({"increase2_2", "requiresNewPath2_2", "runtime2_2"}, "2_2")},
+        {"2.3", withWork({"maxFlow2_3", "runtime2_3"}, "2_3")},
+        {"2.4", {"earliestFinish2_4", "runtime2_4"}},
+        {"2.5", {"maxWaitTime2_5", "runtime2_5"}},
+    };
+
+/**
+ * @brief The options that take a value.
+ */
+static const std::set<std::string> OPTIONS{
+    "-s", "--scenarios", "-g", "--group-size", "-i", "--increase",
+    "-e", "--engine",    "-j", "--threads",    "-o", "--output",
+    "-f", "--format"};
+
+static const std::string USAGE =
+    "Usage: da_proj2 [options] [dataset...]\n"
+    "\n"
+    "Runs scenarios on the given datasets, or on every available dataset,\n"
+    "without the user interface.\n"
+    "\n"
+    "  -s, --scenarios LIST    scenarios to run, separated by commas\n"
+    "                          (default: 1.1,1.2,2.1,2.2,2.3,2.4,2.5)\n"
+    "  -g, --group-size LIST   group sizes of scenarios 2.1 and 2.2,\n"
+    "                          separated by commas, each with its own row\n"
+    "                          (all found with a single flow)\n"
+    "  -i, --increase N        group size increase of scenario 2.2\n"
+    "  -e, --engine NAME       edmonds-karp (default), dinic or push-relabel\n"
+    "  -j, --threads N         datasets to solve at once, 0 for every core\n"
+    "                          (default: 1)\n"
+    "  -o, --output PATH       where to write the results, - for the\n"
+    "                          standard output (default: -)\n"
+    "  -f, --format csv|json   format of the results (default: json if the\n"
+    "                          output ends in .json, csv otherwise)\n"
+    "  -h, --help              show this message\n"
+    "\n"
+    "Run da_proj2 --serve --help to keep datasets loaded and answer queries.\n"
+    "Set DA_PROJ2_TRACE to a path to write a Chrome trace of the run there.\n";
+
+/**
+ * @brief What the command line asks for.
+ */
+struct BatchOptions {
+    std::vector<std::string> datasets{};
+    std::set<std::string> scenarios{"1.1", "1.2", "2.1", "2.2",
+                                    "2.3", "2.4", "2.5"};
+    std::vector<int> groupSizes{};
+    int increase = -1;
+    FlowEngine engine = FlowEngine::EDMONDS_KARP;
+    unsigned threads = 1;
+    std::string output = "-";
+    std::string format{};
+};
+
+/**
+ * @brief Thrown when the arguments are invalid.
+ */
+class UsageError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Parses a whole argument as a number no lower than the given one.
+ */
+static int parseNumber(const std::string &option, const std::string &value,
+                       int min) {
+    int number;
+    auto [end, error] =
+        std::from_chars(value.data(), value.data() + value.size(), number);
+
+    if (error != std::errc{} || end != value.data() + value.size() ||
+        number < min)
+        throw UsageError{option + " expects a number of at least " +
+                         std::to_string(min) + ", got '" + value + "'"};
+
+    return number;
+}
+
+/**
+ * @brief Parses the command line.
+ *
+ * @throws Exit If the usage was asked for.
+ * @throws UsageError If the arguments are invalid.
+ */
+static BatchOptions parseOptions(int argc, char **argv) {
+    BatchOptions options{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help")
+            throw Exit{};
+
+        if (!arg.starts_with('-')) {
+            options.datasets.push_back(arg);
+            continue;
+        }
+
+        if (!OPTIONS.contains(arg))
+            throw UsageError{"unknown option '" + arg + "'"};
+
+        if (i + 1 == argc)
+            throw UsageError{arg + " expects a value"};
+
+        std::string value = argv[++i];
+
+        if (arg == "-s" || arg == "--scenarios") {
+            options.scenarios.clear();
+
+            for (const std::string &scenario : split(value, ',')) {
+                if (std::find_if(SCENARIOS.begin(), SCENARIOS.end(),
+                                 [&](const auto &s) {
+                                     return s.first == scenario;
+                                 }) == SCENARIOS.end())
+                    throw UsageError{"unknown scenario '" + scenario + "'"};
+
+                options.scenarios.insert(scenario);
+            }
+        } else if (arg == "-g" || arg == "--group-size") {
+            options.groupSizes.clear();
+
+            for (const std::string &size : split(value, ','))
+                options.groupSizes.push_back(parseNumber(arg, size, 1));
+        } else if (arg == "-i" || arg == "--increase") {
+            options.increase = parseNumber(arg, value, 1);
+        } else if (arg == "-e" || arg == "--engine") {
+            auto engine = parseFlowEngine(value);
+            if (!engine)
+                throw UsageError{"unknown engine '" + value + "'"};
+
+            options.engine = *engine;
+        } else if (arg == "-j" || arg == "--threads") {
+            options.threads = parseNumber(arg, value, 0);
+        } else if (arg == "-o" || arg == "--output") {
+            options.output = value;
+        } else {
+            if (value != "csv" && value != "json")
+                throw UsageError{"unknown format '" + value + "'"};
+
+            options.format = value;
+        }
+    }
+
+    if (options.scenarios.empty())
+        throw UsageError{"no scenarios to run"};
+
+    if ((options.scenarios.contains("2.1") ||
+         options.scenarios.contains("2.2")) &&
+        options.groupSizes.empty())
+        throw UsageError{"scenarios 2.1 and 2.2 need --group-size"};
+
+    if (options.scenarios.contains("2.2") && options.increase == -1)
+        throw UsageError{"scenario 2.2 needs --increase"};
+
+    if (options.datasets.empty())
+        for (const std::string &name : Dataset::getAvailableDatasets())
+            if (name != OUTPUT_FILE)
+                options.datasets.push_back(name);
+
+    if (options.format.empty())
+        options.format = options.output.ends_with(".json") ? "json" : "csv";
+
+    return options;
+}
+
+/**
+ * @brief Runs the chosen scenarios on a dataset.
+ *
+ * @details Scenarios 2.1 and 2.2 are run for every group size, with 2.1 found
+ *          for all of them with a single flow. The other scenarios don't
+ *          depend on the group size, so they are only run once and repeated
+ *          in every row.
+ *
+ * @return The values of the columns of the chosen scenarios, in order, for
+ *         each group size.
+ */
+static std::vector<std::vector<long long>>
+runScenarios(const BatchOptions &options, Dataset &dataset) {
+    auto &r1 = dataset.getScenario1Result();
+    auto &r2 = dataset.getScenario2Result();
+    auto wants = [&](const std::string &scenario) {
+        return options.scenarios.contains(scenario);
+    };
+
+    std::vector<long long> values{};
+
+    if (wants("1.1")) {
+        scenario1_1(dataset);
+        values.insert(values.end(), {r1.capacity1_1, r1.connections1_1,
+                                     r1.runtime1_1.count()});
+        addWork(values, r1.work1_1);
+    }
+
+    if (wants("1.2")) {
+        scenario1_2(dataset);
+        values.insert(values.end(), {r1.capacity1_2, r1.connections1_2,
+                                     r1.runtime1_2.count()});
+        addWork(values, r1.work1_2);
+    }
+
+    std::vector<std::vector<long long>> rows{};
+
+    // 2.2 changes the path of 2.1, and 2.4 and 2.5 use the path of 2.3
+    if (wants("2.1") || wants("2.2")) {
+        auto sweep =
+            scenario2_1Sweep(dataset, options.groupSizes, options.engine);
+
+        for (const Scenario2Result &result : sweep) {
+            std::vector<long long> row = values;
+            r2 = result;
+
+            if (wants("2.1")) {
+                row.insert(row.end(),
+                           {r2.groupSize2_1, r2.runtime2_1.count()});
+                addWork(row, r2.work2_1);
+            }
+
+            if (wants("2.2")) {
+                if (r2.groupSize2_1 != -1)
+                    scenario2_2(dataset, options.increase, options.engine);
+
+                row.insert(row.end(), {r2.increase2_2, r2.requiresNewPath2_2,
+                                       r2.runtime2_2.count()});
+                addWork(row, r2.work2_2);
+            }
+
+            rows.push_back(std::move(row));
+        }
+    } else {
+        rows.push_back(std::move(values));
+    }
+
+    values.clear();
+
+    if (wants("2.3") || wants("2.4") || wants("2.5"))
+        scenario2_3(dataset, options.engine);
+
+    if (wants("2.3")) {
+        values.insert(values.end(), {r2.maxFlow2_3, r2.runtime2_3.count()});
+        addWork(values, r2.work2_3);
+    }
+
+    if (wants("2.4")) {
+        scenario2_4(dataset, r2.path2_3);
+        values.insert(values.end(),
+                      {r2.earliestFinish2_4, r2.runtime2_4.count()});
+    }
+
+    if (wants("2.5")) {
+        scenario2_5(dataset, r2.path2_3);
+        values.insert(values.end(),
+                      {r2.maxWaitTime2_5, r2.runtime2_5.count()});
+    }
+
+    for (auto &row : rows)
+        row.insert(row.end(), values.begin(), values.end());
+
+    return rows;
+}
+
+/**
+ * @brief Quotes a string for JSON.
+ */
+static std::string jsonString(const std::string &str) {
+    std::ostringstream out{};
+    out << '"';
+
+    for (char c : str) {
+        if (c == '"' || c == '\\')
+            out << '\\' << c;
+        else if ((unsigned char)c < 0x20)
+            out << "\\u00" << "0123456789abcdef"[c >> 4]
+                << "0123456789abcdef"[c & 0xf];
+        else
+            out << c;
+    }
+
+    out << '"';
+    return out.str();
+}
+
+int runBatch(int argc, char **argv) {
+    BatchOptions options;
+
+    try {
+        options = parseOptions(argc, argv);
+    } catch (Exit) {
+        std::cout << USAGE;
+        return 0;
+    } catch (const UsageError &e) {
+        std::cerr << "da_proj2: " << e.what() << "\n\n" << USAGE;
+        return 2;
+    }
+
+    std::ofstream file{};
+    if (options.output != "-") {
+        file.open(options.output);
+
+        if (!file.is_open()) {
+            std::cerr << "da_proj2: can't write to " << options.output << '\n';
+            return 1;
+        }
+    }
+
+    std::ostream &out = options.output == "-" ? std::cout : file;
+    bool json = options.format == "json", first = true;
+
+    std::vector<std::string> columns{};
+    for (const auto &[scenario, names] : SCENARIOS)
+        if (options.scenarios.contains(scenario))
+            columns.insert(columns.end(), names.begin(), names.end());
+
+    if (json) {
+        out << '[';
+    } else {
+        out << "dataset";
+        for (const std::string &column : columns)
+            out << ',' << column;
+        out << '\n';
+    }
+
+    bool solved = solveDatasets(
+        options.datasets, options.threads,
+        [&](const std::string &name, Dataset &dataset) {
+            auto rows = runScenarios(options, dataset);
+            std::ostringstream lines{};
+
+            for (size_t row = 0; row < rows.size(); ++row) {
+                const auto &values = rows[row];
+
+                if (json) {
+                    lines << (row == 0 ? "" : ",") << "\n  {\"dataset\": "
+                          << jsonString(name);
+                    for (size_t i = 0; i < columns.size(); ++i)
+                        lines << ", \"" << columns[i] << "\": " << values[i];
+                    lines << '}';
+                } else {
+                    lines << name;
+                    for (long long value : values)
+                        lines << ',' << value;
+                    lines << '\n';
+                }
+            }
+
+            return lines.str();
+        },
+        [&](const std::string &line) {
+            if (json && !first)
+                out << ',';
+
+            out << line;
+            first = false;
+        });
+
+    if (json)
+        out << (first ? "]\n" : "\n]\n");
+
+    out.flush();
+
+    if (!out) {
+        std::cerr << "da_proj2: can't write to " << options.output << '\n';
+        return 1;
+    }
+
+    return solved ? 0 : 1;
+}
@@ -0,0 +1,371 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "../includes/constants.hpp"
+#include "../includes/residual_network.hpp"
+#include "../includes/scenarios.hpp"
+#include "../includes/tracer.hpp"
+#include "../includes/utils.hpp"
+
+static const std::string USAGE =
+    "Usage: da_proj2_benchmark [options] [dataset...]\n"
+    "\n"
+    "Times every scenario and graph primitive on the given datasets, or on\n"
+    "every available dataset, and reports statistics of the samples.\n"
+    "\n"
+    "  -w, --warmup N        untimed runs before the timed ones (default: 3)\n"
+    "  -r, --repetitions N   timed runs (default: 20)\n"
+    "  -b, --filter TEXT     only run benchmarks whose name contains TEXT\n"
+    "  -g, --group-size N    group size of scenarios 2.1 and 2.2 (default: 2)\n"
+    "  -i, --increase N      group size increase of scenario 2.2 (default: 1)\n"
+    "  -o, --output PATH     where to write the results, - for the standard\n"
+    "                        output (default: -)\n"
+    "  -f, --format csv|json format of the results (default: json if the\n"
+    "                        output ends in .json, csv otherwise)\n"
+    "  -h, --help            show this message\n";
+
+/**
+ * @brief What the command line asks for.
+ */
+struct BenchmarkOptions {
+    std::vector<std::string> datasets{};
+    int warmup = 3;
+    int repetitions = 20;
+    std::string filter{};
+    int groupSize = 2;
+    int increase = 1;
+    std::string output = "-";
+    std::string format{};
+};
+
+/**
+ * @brief The statistics of the samples of a benchmark, in nanoseconds.
+ */
+struct Statistics {
+    std::string dataset;
+    std::string benchmark;
+    long long min;
+    long long median;
+    double mean;
+    long long p95;
+    long long p99;
+    long long max;
+};
+
+/**
+ * @brief Keeps the results of the benchmarks alive, so that the compiler
+ *        can't drop the work that produced them.
+ */
+static volatile long long sink = 0;
+
+/**
+ * @brief Runs a benchmark, untimed for the warm-up and then timed.
+ *
+ * @param setup Prepares each run, outside of the timing, and returns the
+ *              state the run starts from.
+ * @param body The work that is timed, given the state from setup, which
+ *             returns some result of it.
+ *
+ * @return The sorted samples, in nanoseconds.
+ */
+template <typename Setup, typename Body>
+static std::vector<long long> measure(const BenchmarkOptions &options,
+                                      Setup setup, Body body) {
+    std::vector<long long> samples{};
+
+    for (int i = 0; i < options.warmup + options.repetitions; ++i) {
+        auto state = setup();
+
+        auto tstart = std::chrono::steady_clock::now();
+        sink = sink + body(state);
+        auto tend = std::chrono::steady_clock::now();
+
+        if (i >= options.warmup)
+            samples.push_back(
+                std::chrono::duration_cast<std::chrono::nanoseconds>(tend -
+                                                                     tstart)
+                    .count());
+    }
+
+    std::sort(samples.begin(), samples.end());
+    return samples;
+}
+
+/**
+ * @brief Sums up sorted samples.
+ */
+static Statistics summarize(const std::string &dataset,
+                            const std::string &benchmark,
+                            const std::vector<long long> &samples) {
+    // nearest rank, so every statistic is a sample that was measured
+    auto percentile = [&](int p) {
+        size_t rank = (samples.size() * p + 99) / 100;
+        return samples[std::max<size_t>(rank, 1) - 1];
+    };
+
+    double total = 0;
+    for (long long sample : samples)
+        total += sample;
+
+    return {dataset,       benchmark,       samples.front(),
+            percentile(50), total / samples.size(), percentile(95),
+            percentile(99), samples.back()};
+}
+
+/**
+ * @brief Loads a dataset, or exits if it can't be benchmarked.
+ */
+static Dataset loadDataset(const std::string &name) {
+    try {
+        if (!std::filesystem::exists(DATASETS_PATH + name))
+            throw ParseError{name + ": no such dataset"};
+
+        Dataset dataset = Dataset::load(name);
+
+        if (dataset.getN() == -1)
+            throw ParseError{name + ": not a dataset"};
+
+        return dataset;
+    } catch (const ParseError &e) {
+        std::cerr << e.what() << '\n';
+        std::exit(1);
+    }
+}
+
+/**
+ * @brief Runs every benchmark on a dataset.
+ */
+static void benchmarkDataset(const BenchmarkOptions &options,
+                             const std::string &name,
+                             std::vector<Statistics> &results) {
+    Dataset dataset = loadDataset(name);
+    const CsrGraph &graph = dataset.getGraph();
+    int n = graph.getN();
+
+    auto run = [&](const std::string &benchmark, auto setup, auto body) {
+        if (benchmark.find(options.filter) == std::string::npos)
+            return;
+
+        std::cerr << name << ' ' << benchmark << '\n';
+        results.push_back(
+            summarize(name, benchmark, measure(options, setup, body)));
+    };
+
+    auto none = []() { return 0; };
+    TraversalWorkspace forward{}, backward{};
+
+    // the primitives
+    run("bfs", none, [&](int) {
+        graph.bfs(1, n, forward);
+        return forward.getParent(n);
+    });
+    run("bidirectional_bfs", none, [&](int) {
+        return graph.bidirectionalBfs(1, n, forward, backward);
+    });
+    run("widest_path", none,
+        [&](int) { return graph.widestPath(1, n, forward); });
+    run(
+        "edmonds_karp_bfs",
+        [&]() { return std::make_shared<ResidualNetwork>(graph); },
+        [&](auto &network) { return network->edmondsKarpBFS(1, n); });
+
+    const std::pair<std::string, FlowEngine> engines[]{
+        {"edmonds_karp", FlowEngine::EDMONDS_KARP},
+        {"dinic", FlowEngine::DINIC},
+        {"push_relabel", FlowEngine::PUSH_RELABEL}};
+
+    for (const auto &[engineName, engine] : engines)
+        run("max_flow_" + engineName, none,
+            [&](int) { return graph.maxFlow(engine, 1, n).first; });
+
+    CsrGraph flowPaths{graph.maxFlow(FlowEngine::EDMONDS_KARP, 1, n).second};
+    std::vector<int> earliestStart, earliestArrival;
+
+    run("topological_sort", none, [&](int) {
+        return earliestStartTimes(flowPaths, earliestStart, earliestArrival);
+    });
+
+    // the scenarios, as the user interface runs them
+    auto &r2 = dataset.getScenario2Result();
+
+    run("scenario1_1", none, [&](int) {
+        scenario1_1(dataset);
+        return dataset.getScenario1Result().capacity1_1;
+    });
+    run("scenario1_2", none, [&](int) {
+        scenario1_2(dataset);
+        return dataset.getScenario1Result().connections1_2;
+    });
+    run("scenario2_1", none, [&](int) {
+        scenario2_1(dataset, options.groupSize);
+        return r2.groupSize2_1;
+    });
+    run(
+        "scenario2_2",
+        [&]() {
+            scenario2_1(dataset, options.groupSize);
+            return r2.groupSize2_1;
+        },
+        [&](int groupSize) {
+            if (groupSize != -1)
+                scenario2_2(dataset, options.increase);
+            return r2.increase2_2;
+        });
+    run("scenario2_3", none, [&](int) {
+        scenario2_3(dataset);
+        return r2.maxFlow2_3;
+    });
+
+    scenario2_3(dataset);
+    Graph path = r2.path2_3;
+
+    run("scenario2_4", none, [&](int) {
+        scenario2_4(dataset, path);
+        return r2.earliestFinish2_4;
+    });
+    run("scenario2_5", none, [&](int) {
+        scenario2_5(dataset, path);
+        return r2.maxWaitTime2_5;
+    });
+}
+
+/**
+ * @brief Parses a whole argument as a number no lower than the given one.
+ *
+ * @return The number, or -1 if it isn't valid.
+ */
+static int parseNumber(const std::string &value, int min) {
+    try {
+        size_t end;
+        int number = std::stoi(value, &end);
+
+        return end == value.size() && number >= min ? number : -1;
+    } catch (const std::logic_error &) {
+        return -1;
+    }
+}
+
+int main(int argc, char **argv) {
+    if (const char *trace = std::getenv(TRACE_VARIABLE.c_str()))
+        Tracer::enable(trace);
+
+    BenchmarkOptions options{};
+
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            std::cout << USAGE;
+            return 0;
+        }
+
+        if (!arg.starts_with('-')) {
+            options.datasets.push_back(arg);
+            continue;
+        }
+
+        std::string value = i + 1 < argc ? argv[++i] : "";
+        bool valid = !value.empty();
+
+        if (arg == "-w" || arg == "--warmup")
+            valid = (options.warmup = parseNumber(value, 0)) != -1;
+        else if (arg == "-r" || arg == "--repetitions")
+            valid = (options.repetitions = parseNumber(value, 1)) != -1;
+        else if (arg == "-b" || arg == "--filter")
+            options.filter = value;
+        else if (arg == "-g" || arg == "--group-size")
+            valid = (options.groupSize = parseNumber(value, 1)) != -1;
+        else if (arg == "-i" || arg == "--increase")
+            valid = (options.increase = parseNumber(value, 1)) != -1;
+        else if (arg == "-o" || arg == "--output")
+            options.output = value;
+        else if (arg == "-f" || arg == "--format")
+            valid = (options.format = value) == "csv" || value == "json";
+        else
+            valid = false;
+
+        if (!valid) {
+            std::cerr << "da_proj2_benchmark: invalid option '" << arg
+                      << "'\n\n"
+                      << USAGE;
+            return 2;
+        }
+    }
+
+    if (options.datasets.empty())
+        for (const std::string &name : Dataset::getAvailableDatasets())
+            if (name != OUTPUT_FILE)
+                options.datasets.push_back(name);
+
+    if (options.format.empty())
+        options.format = options.output.ends_with(".json") ? "json" : "csv";
+
+    std::vector<Statistics> results{};
+
+    for (const std::string &name : options.datasets)
+        benchmarkDataset(options, name, results);
+
+    std::ofstream file{};
+    if (options.output != "-")
+        file.open(options.output);
+
+    std::ostream &out = options.output == "-" ? std::cout : file;
+
+    if (options.format == "json") {
+        char timestamp[32];
+        std::time_t now = std::time(nullptr);
+        std::strftime(timestamp, sizeof timestamp, "%Y-%m-%dT%H:%M:%SZ",
+                      std::gmtime(&now));
+
+        // timings of different builds can't be compared
+        out << "{\"timestamp\": \"" << timestamp
+            << "\", \"build_type\": \"" << BUILD_TYPE
+            << "\", \"warmup\": " << options.warmup
+            << ", \"repetitions\": " << options.repetitions
+            << ", \"results\": [";
+
+        for (size_t i = 0; i < results.size(); ++i) {
+            const Statistics &s = results[i];
+
+            out << (i == 0 ? "\n" : ",\n") << "  {\"dataset\": \""
+                << s.dataset << "\", \"benchmark\": \"" << s.benchmark
+                << "\", \"min_ns\": " << s.min
+                << ", \"median_ns\": " << s.median
+                << ", \"mean_ns\": " << std::llround(s.mean)
+                << ", \"p95_ns\": " << s.p95 << ", \"p99_ns\": " << s.p99
+                << ", \"max_ns\": " << s.max << '}';
+        }
+
+        out << "\n]}\n";
+    } else {
+        out << "dataset,benchmark,repetitions,min_ns,median_ns,mean_ns,"
+               "p95_ns,p99_ns,max_ns\n";
+
+        for (const Statistics &s : results)
+            out << s.dataset << ',' << s.benchmark << ','
+                << options.repetitions << ',' << s.min << ',' << s.median
+                << ',' << std::llround(s.mean) << ',' << s.p95 << ','
+                << s.p99 << ',' << s.max << '\n';
+    }
+
+    out.flush();
+
+    if (!out) {
+        std::cerr << "da_proj2_benchmark: can't write to " << options.output
+                  << '\n';
+        return 1;
+    }
+
+    return 0;
+}
@@ -0,0 +1,44 @@
+#include "../includes/bucket_queue.hpp"
+
+BucketQueue::BucketQueue(int n, int minKey, int maxKey)
+    : minKey(minKey), top(maxKey - minKey), heads(maxKey - minKey + 1, -1),
+      next(n + 1, -1), prev(n + 1, -1), buckets(n + 1, -1) {}
+
+void BucketQueue::unlink(int node) {
+    if (prev[node] != -1)
+        next[prev[node]] = next[node];
+    else
+        heads[buckets[node]] = next[node];
+
+    if (next[node] != -1)
+        prev[next[node]] = prev[node];
+
+    buckets[node] = -1;
+    --size;
+}
+
+void BucketQueue::push(int node, int key) {
+    if (buckets[node] != -1)
+        unlink(node);
+
+    int bucket = key - minKey;
+
+    prev[node] = -1;
+    next[node] = heads[bucket];
+    if (heads[bucket] != -1)
+        prev[heads[bucket]] = node;
+    heads[bucket] = node;
+
+    buckets[node] = bucket;
+    ++size;
+}
+
+int BucketQueue::pop() {
+    while (heads[top] == -1)
+        --top;
+
+    int node = heads[top];
+    unlink(node);
+
+    return node;
+}
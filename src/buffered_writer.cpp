@@ -0,0 +1,36 @@
+#include <algorithm>
+#include <charconv>
+
+#include "../includes/buffered_writer.hpp"
+
+BufferedWriter::BufferedWriter(const std::string &path)
+    : out(path, std::ios::binary), buffer(BUFFER_SIZE) {}
+
+void BufferedWriter::write(long long number) {
+    // enough for any long long, with its sign
+    reserve(20);
+
+    auto [end, error] =
+        std::to_chars(buffer.data() + used, buffer.data() + buffer.size(),
+                      number);
+    used = end - buffer.data();
+}
+
+void BufferedWriter::write(std::string_view text) {
+    reserve(text.size());
+
+    // too long for the buffer, so it goes straight to the file
+    if (text.size() > buffer.size()) {
+        out.write(text.data(), text.size());
+        return;
+    }
+
+    std::copy(text.begin(), text.end(), buffer.begin() + used);
+    used += text.size();
+}
+
+void BufferedWriter::flush() {
+    out.write(buffer.data(), used);
+    out.flush();
+    used = 0;
+}
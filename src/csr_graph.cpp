@@ -0,0 +1,656 @@
+#include <algorithm>
+#include <fstream>
+
+#include "../includes/bitmap.hpp"
+#include "../includes/bucket_queue.hpp"
+#include "../includes/constants.hpp"
+#include "../includes/csr_graph.hpp"
+#include "../includes/dary_heap.hpp"
+#include "../includes/dot_writer.hpp"
+#include "../includes/mapped_file.hpp"
+#include "../includes/residual_network.hpp"
+#include "../includes/utils.hpp"
+
+CsrGraph::CsrGraph(const Graph &graph) {
+    for (const auto &[label, node] : graph.getNodes())
+        n = std::max(n, label);
+
+    std::vector<CsrEdge> edges{};
+
+    for (const auto &[label, node] : graph.getNodes())
+        for (const auto &[dest, edge] : node.adj)
+            edges.push_back({label, dest, edge.capacity, edge.duration});
+
+    build(edges);
+}
+
+CsrGraph::CsrGraph(int n, const std::vector<CsrEdge> &edges) : n(n) {
+    build(edges);
+}
+
+/**
+ * @brief The arrays a CsrGraph is built into, when it isn't loaded from a
+ *        snapshot.
+ */
+struct CsrArrays {
+    std::vector<int> offsets, dests, capacities, durations, reverseOffsets,
+        reverseSources, reverseEdges;
+};
+
+void CsrGraph::build(const std::vector<CsrEdge> &edges) {
+    auto arrays = std::make_shared<CsrArrays>();
+    auto &[offsets, dests, capacities, durations, reverseOffsets,
+           reverseSources, reverseEdges] = *arrays;
+
+    // count the edges of each node, then turn the counts into offsets
+    std::vector<int> starts(n + 2, 0);
+
+    for (const CsrEdge &edge : edges)
+        ++starts[edge.src + 1];
+
+    for (int i = 1; i <= n + 1; ++i)
+        starts[i] += starts[i - 1];
+
+    // group the edges by source, keeping the order they were given in
+    std::vector<int> order(edges.size());
+    std::vector<int> next{starts.begin(), starts.end() - 1};
+
+    for (size_t i = 0; i < edges.size(); ++i)
+        order[next[edges[i].src]++] = i;
+
+    offsets.assign(n + 2, 0);
+    dests.reserve(edges.size());
+    capacities.reserve(edges.size());
+    durations.reserve(edges.size());
+
+    for (int src = 0; src <= n; ++src) {
+        offsets[src] = dests.size();
+
+        auto begin = order.begin() + starts[src],
+             end = order.begin() + starts[src + 1];
+
+        std::stable_sort(begin, end, [&](int a, int b) {
+            return edges[a].dest < edges[b].dest;
+        });
+
+        for (auto it = begin; it != end; ++it) {
+            const CsrEdge &edge = edges[*it];
+
+            // only the first edge between two nodes is kept
+            if (dests.size() > (size_t)offsets[src] &&
+                dests.back() == edge.dest)
+                continue;
+
+            dests.push_back(edge.dest);
+            capacities.push_back(edge.capacity);
+            durations.push_back(edge.duration);
+        }
+    }
+
+    offsets[n + 1] = dests.size();
+    int m = dests.size();
+
+    if (m > 0) {
+        auto [min, max] =
+            std::minmax_element(capacities.begin(), capacities.end());
+        minCapacity = *min;
+        maxCapacity = *max;
+    }
+
+    // index the edges by destination too, so they can be walked backwards
+    reverseOffsets.assign(n + 2, 0);
+
+    for (int e = 0; e < m; ++e)
+        ++reverseOffsets[dests[e] + 1];
+
+    for (int i = 1; i <= n + 1; ++i)
+        reverseOffsets[i] += reverseOffsets[i - 1];
+
+    reverseSources.resize(m);
+    reverseEdges.resize(m);
+
+    next.assign(reverseOffsets.begin(), reverseOffsets.end() - 1);
+
+    for (int src = 1; src <= n; ++src) {
+        for (int e = offsets[src]; e < offsets[src + 1]; ++e) {
+            int r = next[dests[e]]++;
+
+            reverseSources[r] = src;
+            reverseEdges[r] = e;
+        }
+    }
+
+    storage = arrays;
+    this->offsets = arrays->offsets;
+    this->dests = arrays->dests;
+    this->capacities = arrays->capacities;
+    this->durations = arrays->durations;
+    this->reverseOffsets = arrays->reverseOffsets;
+    this->reverseSources = arrays->reverseSources;
+    this->reverseEdges = arrays->reverseEdges;
+}
+
+/**
+ * @brief The header at the start of a snapshot.
+ */
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t headerSize;
+    int64_t nodes;
+    int64_t edges;
+    int32_t minCapacity;
+    int32_t maxCapacity;
+    /** @brief FNV-1a of the 32 bit words after the header. */
+    uint64_t checksum;
+};
+
+static const char SNAPSHOT_MAGIC[8] = {'D', 'A', 'C', 'S', 'R', 0, 0, 0};
+static const uint32_t SNAPSHOT_VERSION = 1;
+
+static const uint64_t SNAPSHOT_CHECKSUM_START = 14695981039346656037ull;
+
+/**
+ * @brief Adds some words of a snapshot to its checksum.
+ *
+ * @param hash The checksum of the words before these.
+ * @param words The words.
+ * @return The checksum with the words added.
+ */
+static uint64_t snapshotChecksum(uint64_t hash, std::span<const int> words) {
+    for (int word : words) {
+        hash ^= (uint32_t)word;
+        hash *= 1099511628211ull;
+    }
+
+    return hash;
+}
+
+bool CsrGraph::saveSnapshot(const std::string &path) const {
+    // the arrays in the order they are stored
+    const std::span<const int> arrays[]{offsets,        dests,
+                                        capacities,     durations,
+                                        reverseOffsets, reverseSources,
+                                        reverseEdges};
+
+    SnapshotHeader header{};
+    std::copy(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+              header.magic);
+    header.version = SNAPSHOT_VERSION;
+    header.headerSize = sizeof(SnapshotHeader);
+    header.nodes = n;
+    header.edges = dests.size();
+    header.minCapacity = minCapacity;
+    header.maxCapacity = maxCapacity;
+
+    header.checksum = SNAPSHOT_CHECKSUM_START;
+    for (auto array : arrays)
+        header.checksum = snapshotChecksum(header.checksum, array);
+
+    std::ofstream out{path, std::ios::binary};
+
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    for (auto array : arrays)
+        out.write(reinterpret_cast<const char *>(array.data()),
+                  array.size_bytes());
+
+    return out.good();
+}
+
+CsrGraph CsrGraph::loadSnapshot(const std::string &path) {
+    auto file = std::make_shared<MappedFile>(path);
+    std::string_view contents = file->getContents();
+
+    auto fail = [&](const std::string &message) {
+        throw ParseError{path + ": " + message};
+    };
+
+    if (!file->isOpen())
+        fail("can't be opened");
+
+    if (contents.size() < sizeof(SnapshotHeader))
+        fail("too small to be a snapshot");
+
+    // the mapping is page aligned, so the header and the arrays are aligned
+    const auto *header =
+        reinterpret_cast<const SnapshotHeader *>(contents.data());
+
+    if (!std::equal(std::begin(SNAPSHOT_MAGIC), std::end(SNAPSHOT_MAGIC),
+                    header->magic))
+        fail("not a snapshot");
+
+    if (header->version != SNAPSHOT_VERSION ||
+        header->headerSize != sizeof(SnapshotHeader))
+        fail("unsupported snapshot version " +
+             std::to_string(header->version));
+
+    int64_t n = header->nodes, m = header->edges;
+
+    if (n < 0 || m < 0 || n > INT_MAX - 2 || m > INT_MAX ||
+        contents.size() !=
+            sizeof(SnapshotHeader) + (2 * (n + 2) + 5 * m) * sizeof(int))
+        fail("size doesn't match the header");
+
+    const int *words =
+        reinterpret_cast<const int *>(contents.data() + sizeof(SnapshotHeader));
+
+    if (snapshotChecksum(SNAPSHOT_CHECKSUM_START,
+                         {words, (size_t)(2 * (n + 2) + 5 * m)}) !=
+        header->checksum)
+        fail("checksum doesn't match, the file is corrupted");
+
+    CsrGraph graph{};
+    graph.n = n;
+
+    // takes the next array out of the file
+    auto next = [&](int64_t size) {
+        std::span<const int> array{words, (size_t)size};
+        words += size;
+        return array;
+    };
+
+    graph.offsets = next(n + 2);
+    graph.dests = next(m);
+    graph.capacities = next(m);
+    graph.durations = next(m);
+    graph.reverseOffsets = next(n + 2);
+    graph.reverseSources = next(m);
+    graph.reverseEdges = next(m);
+    graph.storage = file;
+
+    // a file can be crafted to pass the checksum, so everything that is later
+    // used as an index is checked too
+    auto validOffsets = [&](std::span<const int> offsets) {
+        return offsets[0] == 0 && offsets[n + 1] == m &&
+               std::is_sorted(offsets.begin(), offsets.end());
+    };
+    auto inRange = [&](std::span<const int> array, int min, int64_t max) {
+        return std::all_of(array.begin(), array.end(), [&](int value) {
+            return value >= min && value <= max;
+        });
+    };
+
+    if (!validOffsets(graph.offsets) || !validOffsets(graph.reverseOffsets))
+        fail("offsets don't match the number of edges");
+
+    if (!inRange(graph.dests, 1, n) || !inRange(graph.reverseSources, 1, n))
+        fail("node outside of 1 to " + std::to_string(n));
+
+    if (!inRange(graph.reverseEdges, 0, m - 1))
+        fail("edge outside of 0 to " + std::to_string(m - 1));
+
+    // the capacities size the bucket queue of the widest path search, so they
+    // are found again instead of trusting the header
+    if (m > 0) {
+        auto [min, max] = std::minmax_element(graph.capacities.begin(),
+                                              graph.capacities.end());
+        graph.minCapacity = *min;
+        graph.maxCapacity = *max;
+    }
+
+    if (graph.minCapacity != header->minCapacity ||
+        graph.maxCapacity != header->maxCapacity)
+        fail("capacities don't match the header");
+
+    return graph;
+}
+
+int CsrGraph::findEdge(int src, int dest) const {
+    auto begin = dests.begin() + offsets[src],
+         end = dests.begin() + offsets[src + 1];
+    auto it = std::lower_bound(begin, end, dest);
+
+    if (it == end || *it != dest)
+        return -1;
+
+    return it - dests.begin();
+}
+
+void CsrGraph::bfs(int s, int t, TraversalWorkspace &workspace) const {
+    workspace.reset(n);
+    workspace.visit(s, s);
+    COUNT_WORK(WorkCounters &work = workspace.getWorkCounters());
+    COUNT_WORK(++work.bfsPasses);
+
+    if (s == t)
+        return;
+
+    // the nodes found in the last level, as a list when going top-down and as
+    // a bitmap when going bottom-up
+    std::vector<int> frontier{s}, next{};
+    Bitmap frontierBits{}, nextBits{};
+    bool bottomUp = false;
+
+    long frontierSize = 1, frontierEdges = offsets[s + 1] - offsets[s],
+         unvisitedEdges = dests.size() -
+                          (reverseOffsets[s + 1] - reverseOffsets[s]);
+
+    while (frontierSize > 0) {
+        if (!bottomUp &&
+            frontierEdges > unvisitedEdges / BFS_BOTTOM_UP_FACTOR) {
+            frontierBits.clear(n);
+            for (int node : frontier)
+                frontierBits.set(node);
+
+            bottomUp = true;
+        } else if (bottomUp && frontierSize < n / BFS_TOP_DOWN_FACTOR) {
+            frontier.clear();
+            for (int node = 1; node <= n; ++node)
+                if (frontierBits.test(node))
+                    frontier.push_back(node);
+
+            bottomUp = false;
+        }
+
+        frontierSize = frontierEdges = 0;
+
+        if (bottomUp) {
+            // every unvisited node looks for a parent in the frontier, t
+            // first so that the search can stop as soon as it is found
+            nextBits.clear(n);
+
+            for (int i = 0; i <= n; ++i) {
+                int node = i == 0 ? t : i;
+
+                if (workspace.isVisited(node))
+                    continue;
+
+                COUNT_WORK(++work.nodesDequeued);
+
+                for (int r = reverseOffsets[node];
+                     r < reverseOffsets[node + 1]; ++r) {
+                    COUNT_WORK(++work.arcsScanned);
+
+                    if (frontierBits.test(reverseSources[r])) {
+                        workspace.visit(node, reverseSources[r],
+                                        reverseEdges[r]);
+                        nextBits.set(node);
+
+                        ++frontierSize;
+                        frontierEdges += offsets[node + 1] - offsets[node];
+                        unvisitedEdges -= reverseOffsets[node + 1] -
+                                          reverseOffsets[node];
+                        break;
+                    }
+                }
+
+                if (node == t && workspace.isVisited(t))
+                    return;
+            }
+
+            frontierBits.swap(nextBits);
+        } else {
+            next.clear();
+
+            for (int currentNode : frontier) {
+                COUNT_WORK(++work.nodesDequeued);
+
+                for (int e = offsets[currentNode]; e < offsets[currentNode + 1];
+                     ++e) {
+                    int dest = dests[e];
+                    COUNT_WORK(++work.arcsScanned);
+
+                    if (workspace.isVisited(dest))
+                        continue;
+
+                    workspace.visit(dest, currentNode, e);
+
+                    if (dest == t)
+                        return;
+
+                    next.push_back(dest);
+                    frontierEdges += offsets[dest + 1] - offsets[dest];
+                    unvisitedEdges -=
+                        reverseOffsets[dest + 1] - reverseOffsets[dest];
+                }
+            }
+
+            frontier.swap(next);
+            frontierSize = frontier.size();
+        }
+    }
+}
+
+int CsrGraph::bidirectionalBfs(int s, int t, TraversalWorkspace &forward,
+                               TraversalWorkspace &backward) const {
+    forward.reset(n);
+    backward.reset(n);
+
+    forward.visit(s, s);
+    backward.visit(t, t);
+    COUNT_WORK(WorkCounters &forwardWork = forward.getWorkCounters());
+    COUNT_WORK(WorkCounters &backwardWork = backward.getWorkCounters());
+    COUNT_WORK(++forwardWork.bfsPasses);
+    COUNT_WORK(++backwardWork.bfsPasses);
+
+    if (s == t)
+        return s;
+
+    // the nodes found in the last level of each search
+    std::vector<int> forwardFrontier{s}, backwardFrontier{t}, next{};
+
+    while (!forwardFrontier.empty() && !backwardFrontier.empty()) {
+        next.clear();
+
+        // a whole level is expanded at a time, so the first node found by
+        // both searches is in a shortest path
+        if (forwardFrontier.size() <= backwardFrontier.size()) {
+            for (int currentNode : forwardFrontier) {
+                COUNT_WORK(++forwardWork.nodesDequeued);
+
+                for (int e = offsets[currentNode]; e < offsets[currentNode + 1];
+                     ++e) {
+                    int dest = dests[e];
+                    COUNT_WORK(++forwardWork.arcsScanned);
+
+                    if (forward.isVisited(dest))
+                        continue;
+
+                    forward.visit(dest, currentNode, e);
+
+                    if (backward.isVisited(dest))
+                        return dest;
+
+                    next.push_back(dest);
+                }
+            }
+
+            forwardFrontier.swap(next);
+        } else {
+            for (int currentNode : backwardFrontier) {
+                COUNT_WORK(++backwardWork.nodesDequeued);
+
+                for (int r = reverseOffsets[currentNode];
+                     r < reverseOffsets[currentNode + 1]; ++r) {
+                    int src = reverseSources[r];
+                    COUNT_WORK(++backwardWork.arcsScanned);
+
+                    if (backward.isVisited(src))
+                        continue;
+
+                    backward.visit(src, currentNode, reverseEdges[r]);
+
+                    if (forward.isVisited(src))
+                        return src;
+
+                    next.push_back(src);
+                }
+            }
+
+            backwardFrontier.swap(next);
+        }
+    }
+
+    return -1;
+}
+
+/**
+ * @brief The widest path search behind CsrGraph::widestPath(), for any max
+ *        priority queue of nodes.
+ */
+template <typename Queue>
+static int widestPathWith(const CsrGraph &graph, Queue &queue, int s, int t,
+                          TraversalWorkspace &workspace) {
+    workspace.reset(graph.getN());
+
+    // the capacity of the widest path found so far to each node
+    std::vector<int> widths(graph.getN() + 1, 0);
+
+    workspace.visit(s, s);
+    widths[s] = INT_MAX;
+
+    int v = s;
+    COUNT_WORK(WorkCounters &work = workspace.getWorkCounters());
+
+    while (v != t) {
+        COUNT_WORK(++work.nodesDequeued);
+
+        for (int e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+            int w = graph.getDest(e);
+            int width = std::min(widths[v], graph.getCapacity(e));
+            COUNT_WORK(++work.arcsScanned);
+
+            // the start was already expanded, nothing can be wider
+            if (width > widths[w] && w != s) {
+                widths[w] = width;
+                workspace.visit(w, v, e);
+                queue.push(w, width);
+            }
+        }
+
+        if (queue.empty())
+            return -1;
+
+        v = queue.pop();
+    }
+
+    return s == t ? INT_MAX : widths[t];
+}
+
+int CsrGraph::widestPath(int start, int end,
+                         TraversalWorkspace &workspace) const {
+    if ((long)maxCapacity - minCapacity <= (long)n + (long)dests.size()) {
+        BucketQueue queue{n, minCapacity, maxCapacity};
+        return widestPathWith(*this, queue, start, end, workspace);
+    }
+
+    DaryHeap queue{n};
+    return widestPathWith(*this, queue, start, end, workspace);
+}
+
+std::pair<int, Graph> CsrGraph::edmondsKarp(int start, int end,
+                                            int groupSize) const {
+    return maxFlow(FlowEngine::EDMONDS_KARP, start, end, groupSize);
+}
+
+std::pair<int, Graph> CsrGraph::dinic(int start, int end,
+                                      int groupSize) const {
+    return maxFlow(FlowEngine::DINIC, start, end, groupSize);
+}
+
+std::pair<int, Graph> CsrGraph::pushRelabel(int start, int end,
+                                            int groupSize) const {
+    return maxFlow(FlowEngine::PUSH_RELABEL, start, end, groupSize);
+}
+
+std::pair<int, Graph> CsrGraph::maxFlow(FlowEngine engine, int start, int end,
+                                        int groupSize,
+                                        WorkCounters *work) const {
+    ResidualNetwork network{*this};
+
+    int flow = network.maxFlow(engine, start, end, groupSize);
+
+    if (work != nullptr)
+        *work += network.getWorkCounters();
+
+    return {flow, network.toGraph()};
+}
+
+void CsrGraph::toDotFile(const std::string &path,
+                         std::span<const DotOverlay> overlays,
+                         int hops) const {
+    if (hops < 0) {
+        DotWriter out{path, n, overlays};
+
+        for (int src = 1; src <= n; ++src)
+            for (int e = offsets[src]; e < offsets[src + 1]; ++e)
+                out.edge(src, dests[e]);
+
+        return;
+    }
+
+    // how many hops each node is from the paths, or -1 if it is too far
+    std::vector<int> distance(n + 1, -1);
+    std::vector<int> queue{};
+
+    auto reach = [&](int node, int d) {
+        if (node >= 1 && node <= n && distance[node] == -1) {
+            distance[node] = d;
+            queue.push_back(node);
+        }
+    };
+
+    for (const DotOverlay &overlay : overlays)
+        for (const auto &[label, node] : overlay.path.getNodes())
+            reach(label, 0);
+
+    if (overlays.empty()) {
+        reach(1, 0);
+        reach(n, 0);
+    }
+
+    for (size_t i = 0; i < queue.size(); ++i) {
+        int u = queue[i];
+
+        if (distance[u] == hops)
+            continue;
+
+        for (int e = offsets[u]; e < offsets[u + 1]; ++e)
+            reach(dests[e], distance[u] + 1);
+        for (int e = reverseOffsets[u]; e < reverseOffsets[u + 1]; ++e)
+            reach(reverseSources[e], distance[u] + 1);
+    }
+
+    int hiddenNodes = n - queue.size();
+    long long hiddenEdges = getEdgeCount();
+
+    DotWriter out{path, (int)queue.size(), overlays};
+
+    for (int src = 1; src <= n; ++src) {
+        if (distance[src] == -1)
+            continue;
+
+        int toHidden = 0, fromHidden = 0;
+
+        for (int e = offsets[src]; e < offsets[src + 1]; ++e) {
+            if (distance[dests[e]] == -1) {
+                ++toHidden;
+                continue;
+            }
+
+            out.edge(src, dests[e]);
+            --hiddenEdges;
+        }
+
+        for (int e = reverseOffsets[src]; e < reverseOffsets[src + 1]; ++e)
+            fromHidden += distance[reverseSources[e]] == -1;
+
+        if (toHidden > 0)
+            out.summaryEdge(src, DotWriter::SUMMARY_NODE, toHidden);
+        if (fromHidden > 0)
+            out.summaryEdge(DotWriter::SUMMARY_NODE, src, fromHidden);
+    }
+
+    if (hiddenNodes > 0)
+        out.summary(hiddenNodes, hiddenEdges);
+}
+
+Graph CsrGraph::toGraph() const {
+    Graph graph{n};
+
+    for (int src = 1; src <= n; ++src)
+        for (int e = offsets[src]; e < offsets[src + 1]; ++e)
+            graph.addEdge(src, dests[e], capacities[e], durations[e]);
+
+    return graph;
+}
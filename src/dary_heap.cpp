@@ -0,0 +1,67 @@
+#include "../includes/dary_heap.hpp"
+
+DaryHeap::DaryHeap(int n) : positions(n + 1, -1), keys(n + 1, 0) {
+    heap.reserve(n);
+}
+
+void DaryHeap::siftUp(int i) {
+    int node = heap[i];
+
+    while (i > 0) {
+        int parent = (i - 1) / ARITY;
+
+        if (keys[heap[parent]] >= keys[node])
+            break;
+
+        place(i, heap[parent]);
+        i = parent;
+    }
+
+    place(i, node);
+}
+
+void DaryHeap::siftDown(int i) {
+    int node = heap[i], size = heap.size();
+
+    while (true) {
+        int first = i * ARITY + 1, best = -1;
+
+        for (int c = first; c < first + ARITY && c < size; ++c)
+            if (best == -1 || keys[heap[c]] > keys[heap[best]])
+                best = c;
+
+        if (best == -1 || keys[heap[best]] <= keys[node])
+            break;
+
+        place(i, heap[best]);
+        i = best;
+    }
+
+    place(i, node);
+}
+
+void DaryHeap::push(int node, int key) {
+    keys[node] = key;
+
+    if (positions[node] == -1) {
+        heap.push_back(node);
+        positions[node] = heap.size() - 1;
+    }
+
+    siftUp(positions[node]);
+}
+
+int DaryHeap::pop() {
+    int node = heap.front();
+    positions[node] = -1;
+
+    int last = heap.back();
+    heap.pop_back();
+
+    if (!heap.empty()) {
+        place(0, last);
+        siftDown(0);
+    }
+
+    return node;
+}
@@ -1,93 +1,155 @@
 #include <algorithm>
+#include <charconv>
 #include <filesystem>
 #include <fstream>
 #include <list>
 #include <queue>
-#include <random>
 #include <set>
 
+#include "../includes/buffered_writer.hpp"
+#include "../includes/dot_writer.hpp"
 #include "../includes/constants.hpp"
 #include "../includes/dataset.hpp"
+#include "../includes/generator.hpp"
+#include "../includes/graphviz.hpp"
+#include "../includes/mapped_file.hpp"
+#include "../includes/tracer.hpp"
 #include "../includes/utils.hpp"
 
 Dataset::Dataset(const int n, const Graph &graph) : n(n), graph(graph) {}
 
+Dataset::Dataset(const int n, CsrGraph &&graph)
+    : n(n), graph(std::move(graph)) {}
+
 Dataset Dataset::load(const std::string &path) {
     if (path == "output.csv")
         return {};
 
-    std::ifstream dataset_file{DATASETS_PATH + path};
+    TraceSpan span{"Dataset::load"};
 
-    if (!dataset_file.is_open())
-        return {};
+    if (path.ends_with(SNAPSHOT_EXTENSION)) {
+        CsrGraph graph = CsrGraph::loadSnapshot(DATASETS_PATH + path);
+        int n = graph.getN();
 
-    std::string line;
-    std::vector<std::string> tokens;
+        return {n, std::move(graph)};
+    }
 
-    std::getline(dataset_file, line);
+    MappedFile file{DATASETS_PATH + path};
 
-    if (line.empty())
-        return {};
+    if (!file.isOpen())
+        throw ParseError{path + ": can't be opened"};
 
-    tokens = split(line, ' ');
+    // the numbers are parsed straight from the mapped file, without copying
+    // any line
+    std::string_view contents = file.getContents();
+    const char *cur = contents.data(), *end = cur + contents.size();
+    int line = 1;
 
-    int n = stoul(tokens[0]);
-    int t = stoul(tokens[1]);
+    auto fail = [&](const std::string &message) {
+        throw ParseError{path + ":" + std::to_string(line) + ": " + message};
+    };
 
-    Graph result{n};
+    auto readNumber = [&](const std::string &what) {
+        while (cur < end && (*cur == ' ' || *cur == '\t'))
+            ++cur;
 
-    for (int i = 0; i < t; ++i) {
-        std::getline(dataset_file, line);
-        tokens = split(line, ' ');
+        int number = 0;
+        auto [ptr, error] = std::from_chars(cur, end, number);
 
-        int src = stoul(tokens[0]), dest = stoul(tokens[1]),
-            capacity = stoul(tokens[2]), duration = stoul(tokens[3]);
+        if (error != std::errc{} || number < 0)
+            fail("expected " + what);
 
-        result.addEdge(src, dest, capacity, duration);
-    }
+        cur = ptr;
+        return number;
+    };
 
-    Dataset dataset{n, result};
-    return dataset;
-}
+    auto endLine = [&]() {
+        while (cur < end && (*cur == ' ' || *cur == '\t' || *cur == '\r'))
+            ++cur;
 
-Dataset Dataset::generate(const std::string &name,
-                          const DatasetGenerationParams &params) {
-    std::ofstream out{DATASETS_PATH + name + ".txt"};
+        if (cur < end && *cur != '\n')
+            fail("unexpected characters at the end of the line");
 
-    out << params.numberOfNodes << ' ' << params.numberOfEdges << '\n';
+        if (cur < end)
+            ++cur;
+        ++line;
+    };
 
-    Graph graph{params.numberOfNodes};
-    auto &nodesMap = graph.getNodes();
+    if (cur == end || *cur == '\n' || *cur == '\r')
+        fail("expected the number of nodes");
 
-    std::vector<std::pair<int, int>> edges{};
+    int n = readNumber("the number of nodes");
+    int t = readNumber("the number of edges");
 
-    for (int i = 1; i < params.numberOfNodes; ++i)
-        for (int j = i + 1; j <= params.numberOfNodes; ++j)
-            edges.push_back({i, j});
+    // every edge takes at least "1 1 0 0" and a line break, so a count the
+    // rest of the file can't hold is rejected before reserving for it
+    if ((size_t)t > (size_t)(end - cur + 1) / 8)
+        fail("the file is too short for " + std::to_string(t) + " edges");
 
-    // Setup random generators
-    std::random_device rd{};
-    std::mt19937 gen{rd()};
+    endLine();
 
-    std::uniform_int_distribution edgeCapacityDist{params.minEdgeCapacity,
-                                                   params.maxEdgeCapacity},
-        edgeDurationDist{params.minEdgeDuration, params.maxEdgeDuration};
+    std::vector<CsrEdge> edges{};
+    edges.reserve(t);
 
-    std::shuffle(edges.begin(), edges.end(), gen);
+    for (int i = 0; i < t; ++i) {
+        if (cur == end)
+            fail("expected " + std::to_string(t) + " edges, found " +
+                 std::to_string(i));
 
-    for (int i = 0; i < params.numberOfEdges && i < edges.size(); i++) {
-        auto e = edges.at(i);
+        int src = readNumber("the source node"),
+            dest = readNumber("the destination node"),
+            capacity = readNumber("the capacity"),
+            duration = readNumber("the duration");
 
-        int capacity = edgeCapacityDist(gen);
-        int duration = edgeDurationDist(gen);
+        if (src < 1 || src > n || dest < 1 || dest > n)
+            fail("node outside of 1 to " + std::to_string(n));
 
-        graph.addEdge(e.first, e.second, capacity, duration);
+        endLine();
 
-        out << e.first << ' ' << e.second << ' ' << capacity << ' ' << duration
-            << '\n';
+        edges.push_back({src, dest, capacity, duration});
     }
 
-    return {params.numberOfNodes, graph};
+    return {n, CsrGraph{n, edges}};
+}
+
+std::string Dataset::convert(const std::string &path) {
+    Dataset dataset = load(path);
+
+    if (dataset.n == -1)
+        return "";
+
+    std::string snapshot =
+        std::filesystem::path{path}.replace_extension(SNAPSHOT_EXTENSION);
+
+    if (!dataset.graph.saveSnapshot(DATASETS_PATH + snapshot))
+        return "";
+
+    return snapshot;
+}
+
+Dataset Dataset::generate(const std::string &name,
+                          const DatasetGenerationParams &params) {
+    std::vector<CsrEdge> edges = generateEdges(params);
+
+    BufferedWriter out{DATASETS_PATH + name + ".txt"};
+
+    out.write(params.numberOfNodes);
+    out.write(' ');
+    out.write((long long)edges.size());
+    out.write('\n');
+
+    for (const CsrEdge &edge : edges) {
+        out.write(edge.src);
+        out.write(' ');
+        out.write(edge.dest);
+        out.write(' ');
+        out.write(edge.capacity);
+        out.write(' ');
+        out.write(edge.duration);
+        out.write('\n');
+    }
+
+    return {params.numberOfNodes, CsrGraph{params.numberOfNodes, edges}};
 }
 
 std::vector<std::string> Dataset::getAvailableDatasets() {
@@ -103,142 +165,79 @@ std::vector<std::string> Dataset::getAvailableDatasets() {
     return result;
 }
 
-std::unordered_map<Visualization, std::string> Dataset::render() {
-    std::unordered_map<Visualization, std::string> m{};
+std::unordered_map<Visualization, std::string> Dataset::render(int hops) {
+    TraceSpan span{"Dataset::render"};
+    std::vector<std::pair<Visualization, std::string>> visualizations{};
+
+    // the dot files are all written first, so that they can be laid out at
+    // the same time
+    auto toDot = [&](Visualization visualization, const std::string &name,
+                     const std::vector<DotOverlay> &overlays) {
+        graph.toDotFile(OUTPUT_PATH + name + ".dot", overlays, hops);
+        visualizations.emplace_back(visualization, name);
+    };
+    auto pathToDot = [&](Visualization visualization, const std::string &name,
+                         const Graph &path) {
+        path.toDotFile(OUTPUT_PATH + name + ".dot");
+        visualizations.emplace_back(visualization, name);
+    };
 
     // DATASET
-    graph.toDotFile(OUTPUT_PATH + "dataset.dot");
-    std::stringstream command{};
-    command << "sfdp -T svg " << OUTPUT_PATH << "dataset.dot > " << OUTPUT_PATH
-            << "dataset.svg";
-    int r = system(command.str().c_str());
-    if (!r)
-        m.insert({Visualization::DATASET, OUTPUT_PATH + "dataset.svg"});
+    toDot(Visualization::DATASET, "dataset", {});
 
     // 1.1
     if (scenario1Result.capacity1_1 != -1) {
-        scenario1Result.path1_1.toDotFile(OUTPUT_PATH + "1.1only.dot");
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "1.1only.dot > "
-                << OUTPUT_PATH << "1.1only.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_1_1_ONLY,
-                      OUTPUT_PATH + "1.1only.svg"});
-
-        graph.toDotFile(OUTPUT_PATH + "1.1.dot",
-                        {{scenario1Result.path1_1, "Maximum capacity path"}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "1.1.dot > " << OUTPUT_PATH
-                << "1.1.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_1_1, OUTPUT_PATH + "1.1.svg"});
+        pathToDot(Visualization::SCENARIO_1_1_ONLY, "1.1only",
+                  scenario1Result.path1_1);
+        toDot(Visualization::SCENARIO_1_1, "1.1",
+              {{scenario1Result.path1_1, "Maximum capacity path"}});
     }
 
     // 1.2
     if (scenario1Result.capacity1_2 != -1) {
-        scenario1Result.path1_2.toDotFile(OUTPUT_PATH + "1.2only.dot");
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "1.2only.dot > "
-                << OUTPUT_PATH << "1.2only.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_1_2_ONLY,
-                      OUTPUT_PATH + "1.2only.svg"});
-
-        graph.toDotFile(
-            OUTPUT_PATH + "1.2.dot",
-            {{scenario1Result.path1_2, "Minimum connections path"}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "1.2.dot > " << OUTPUT_PATH
-                << "1.2.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_1_2, OUTPUT_PATH + "1.2.svg"});
+        pathToDot(Visualization::SCENARIO_1_2_ONLY, "1.2only",
+                  scenario1Result.path1_2);
+        toDot(Visualization::SCENARIO_1_2, "1.2",
+              {{scenario1Result.path1_2, "Minimum connections path"}});
     }
 
     // 1.1 and 1.2
     if (scenario1Result.capacity1_1 != -1 &&
         scenario1Result.capacity1_2 != -1) {
-        graph.toDotFile(
-            OUTPUT_PATH + "1.dot",
-            {{scenario1Result.path1_1, "Maximum capacity path"},
-             {scenario1Result.path1_2, "Minimum connections path"}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "1.dot > " << OUTPUT_PATH
-                << "1.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_1, OUTPUT_PATH + "1.svg"});
+        toDot(Visualization::SCENARIO_1, "1",
+              {{scenario1Result.path1_1, "Maximum capacity path"},
+               {scenario1Result.path1_2, "Minimum connections path"}});
     }
 
+    std::stringstream label2_1{};
+    label2_1 << "Path for group with size " << scenario2Result.groupSize2_1;
+
+    std::stringstream label2_2{};
+    label2_2 << "Path for group with size " << scenario2Result.groupSize2_1
+             << " + " << scenario2Result.increase2_2;
+
     // 2.1
     if (scenario2Result.groupSize2_1 != -1) {
-        scenario2Result.path2_1.toDotFile(OUTPUT_PATH + "2.1only.dot");
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.1only.dot > "
-                << OUTPUT_PATH << "2.1only.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_1_ONLY,
-                      OUTPUT_PATH + "2.1only.svg"});
-
-        std::stringstream label{};
-        label << "Path for group with size " << scenario2Result.groupSize2_1;
-        graph.toDotFile(OUTPUT_PATH + "2.1.dot",
-                        {{scenario2Result.path2_1, label.str()}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.1.dot > " << OUTPUT_PATH
-                << "2.1.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_1, OUTPUT_PATH + "2.1.svg"});
+        pathToDot(Visualization::SCENARIO_2_1_ONLY, "2.1only",
+                  scenario2Result.path2_1);
+        toDot(Visualization::SCENARIO_2_1, "2.1",
+              {{scenario2Result.path2_1, label2_1.str()}});
     }
 
     // 2.2
     if (scenario2Result.increase2_2 != -1) {
-        scenario2Result.path2_2.toDotFile(OUTPUT_PATH + "2.2only.dot");
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.2only.dot > "
-                << OUTPUT_PATH << "2.2only.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_2_ONLY,
-                      OUTPUT_PATH + "2.2only.svg"});
-
-        std::stringstream label{};
-        label << "Path for group with size " << scenario2Result.groupSize2_1
-              << " + " << scenario2Result.increase2_2;
-        graph.toDotFile(OUTPUT_PATH + "2.2.dot",
-                        {{scenario2Result.path2_2, label.str()}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.2.dot > " << OUTPUT_PATH
-                << "2.2.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_2, OUTPUT_PATH + "2.2.svg"});
+        pathToDot(Visualization::SCENARIO_2_2_ONLY, "2.2only",
+                  scenario2Result.path2_2);
+        toDot(Visualization::SCENARIO_2_2, "2.2",
+              {{scenario2Result.path2_2, label2_2.str()}});
     }
 
     // 2.3
     if (scenario2Result.maxFlow2_3 != -1) {
-        scenario2Result.path2_3.toDotFile(OUTPUT_PATH + "2.3only.dot");
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.3only.dot > "
-                << OUTPUT_PATH << "2.3only.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_3_ONLY,
-                      OUTPUT_PATH + "2.3only.svg"});
-
-        graph.toDotFile(OUTPUT_PATH + "2.3.dot",
-                        {{scenario2Result.path2_3, "Path with maximum flow"}});
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.3.dot > " << OUTPUT_PATH
-                << "2.3.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2_3, OUTPUT_PATH + "2.3.svg"});
+        pathToDot(Visualization::SCENARIO_2_3_ONLY, "2.3only",
+                  scenario2Result.path2_3);
+        toDot(Visualization::SCENARIO_2_3, "2.3",
+              {{scenario2Result.path2_3, "Path with maximum flow"}});
     }
 
     // 2
@@ -246,35 +245,32 @@ std::unordered_map<Visualization, std::string> Dataset::render() {
             (scenario2Result.increase2_2 != -1) +
             (scenario2Result.maxFlow2_3 != -1) >
         1) {
-        std::vector<std::pair<Graph, std::string>> paths{};
-
-        if (scenario2Result.groupSize2_1 != -1) {
-            std::stringstream label{};
-            label << "Path for group with size "
-                  << scenario2Result.groupSize2_1;
-            paths.emplace_back(scenario2Result.path2_1, label.str());
-        }
-
-        if (scenario2Result.increase2_2 != -1) {
-            std::stringstream label{};
-            label << "Path for group with size " << scenario2Result.groupSize2_1
-                  << " + " << scenario2Result.increase2_2;
-            paths.emplace_back(scenario2Result.path2_2, label.str());
-        }
-
-        if (scenario2Result.maxFlow2_3 != -1) {
-            paths.emplace_back(scenario2Result.path2_3,
-                               "Path with maximum flow");
-        }
-
-        graph.toDotFile(OUTPUT_PATH + "2.dot", paths);
-        command = {};
-        command << "sfdp -T svg " << OUTPUT_PATH << "2.dot > " << OUTPUT_PATH
-                << "2.svg";
-        r = system(command.str().c_str());
-        if (!r)
-            m.insert({Visualization::SCENARIO_2, OUTPUT_PATH + "2.svg"});
+        std::vector<DotOverlay> overlays{};
+
+        if (scenario2Result.groupSize2_1 != -1)
+            overlays.push_back({scenario2Result.path2_1, label2_1.str()});
+
+        if (scenario2Result.increase2_2 != -1)
+            overlays.push_back({scenario2Result.path2_2, label2_2.str()});
+
+        if (scenario2Result.maxFlow2_3 != -1)
+            overlays.push_back(
+                {scenario2Result.path2_3, "Path with maximum flow"});
+
+        toDot(Visualization::SCENARIO_2, "2", overlays);
     }
 
+    std::vector<RenderJob> jobs{};
+    for (const auto &[visualization, name] : visualizations)
+        jobs.push_back(
+            {OUTPUT_PATH + name + ".dot", OUTPUT_PATH + name + ".svg"});
+
+    std::vector<bool> ready = renderDotFiles(jobs);
+
+    std::unordered_map<Visualization, std::string> m{};
+    for (size_t i = 0; i < jobs.size(); ++i)
+        if (ready[i])
+            m.insert({visualizations[i].first, jobs[i].svgPath});
+
     return m;
 }
@@ -0,0 +1,112 @@
+#include <cmath>
+#include <cstdio>
+
+#include "../includes/constants.hpp"
+#include "../includes/dot_writer.hpp"
+
+/**
+ * @brief Picks the color of a path.
+ *
+ * @details The hues are a golden angle apart, so however many paths there are,
+ *          each new one lands far from the ones before it.
+ *
+ * @param i The index of the path.
+ * @return The color, as #rrggbb.
+ */
+static std::string pathColor(int i) {
+    const double saturation = 0.85, value = 0.9;
+    double hue = std::fmod(i * 0.618033988749895, 1.0) * 6;
+
+    // the channel that is at full value, the one in between and the lowest
+    double high = value, low = value * (1 - saturation);
+    double mid = low + (high - low) * (1 - std::fabs(std::fmod(hue, 2) - 1));
+
+    double rgb[6][3]{{high, mid, low}, {mid, high, low}, {low, high, mid},
+                     {low, mid, high}, {mid, low, high}, {high, low, mid}};
+    const double *channels = rgb[(int)hue];
+
+    char color[8];
+    snprintf(color, sizeof color, "#%02x%02x%02x",
+             (int)std::lround(channels[0] * 255),
+             (int)std::lround(channels[1] * 255),
+             (int)std::lround(channels[2] * 255));
+    return color;
+}
+
+DotWriter::DotWriter(const std::string &path, int nodeCount,
+                     std::span<const DotOverlay> overlays)
+    : out(path), overlays(overlays) {
+    out.write(DOT_HEADER);
+
+    if (nodeCount < 100)
+        out.write("splines=true\n");
+
+    if (overlays.empty())
+        return;
+
+    out.write("{ Legend [shape=none, margin=0, label=<"
+              "<table border=\"0\" cellborder=\"1\" cellspacing=\"0\" "
+              "cellpadding=\"4\">");
+
+    for (int i = 0; i < (int)overlays.size(); ++i) {
+        colors.push_back(pathColor(i));
+
+        out.write("<tr><td bgcolor=\"");
+        out.write(colors.back());
+        out.write("\"></td><td>");
+        out.write(i + 1);
+        out.write(". ");
+        out.write(overlays[i].label);
+        out.write("</td></tr>");
+    }
+
+    out.write("</table>>]}\n");
+}
+
+DotWriter::~DotWriter() { out.write("}\n"); }
+
+void DotWriter::edge(int src, int dest) {
+    out.write(src);
+    out.write(" -> ");
+    out.write(dest);
+    out.write(" [color=\"");
+
+    bool inPath = false;
+
+    for (int i = 0; i < (int)overlays.size(); ++i) {
+        const auto &nodes = overlays[i].path.getNodes();
+        auto it = nodes.find(src);
+
+        if (it == nodes.end() || !it->second.adj.contains(dest))
+            continue;
+
+        if (inPath)
+            out.write(':');
+
+        out.write(colors[i]);
+        inPath = true;
+    }
+
+    if (!inPath)
+        out.write("black");
+
+    out.write("\"]\n");
+}
+
+void DotWriter::summary(int hiddenNodes, long long hiddenEdges) {
+    out.write(SUMMARY_NODE);
+    out.write(" [shape=box, style=dashed, label=\"");
+    out.write(hiddenNodes);
+    out.write(" other nodes\\n");
+    out.write(hiddenEdges);
+    out.write(" other edges\"]\n");
+}
+
+void DotWriter::summaryEdge(int src, int dest, int count) {
+    out.write(src);
+    out.write(" -> ");
+    out.write(dest);
+    out.write(" [style=dashed, color=gray, label=\"");
+    out.write(count);
+    out.write("\"]\n");
+}
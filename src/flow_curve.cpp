@@ -0,0 +1,72 @@
+#include <algorithm>
+#include <unordered_map>
+
+#include "../includes/flow_curve.hpp"
+#include "../includes/tracer.hpp"
+
+FlowCurve::FlowCurve(const CsrGraph &graph, FlowEngine engine, int start,
+                     int end, int limit)
+    : graph(graph), n(graph.getN()) {
+    TraceSpan span{"FlowCurve::FlowCurve"};
+
+    ResidualNetwork network{graph};
+    int flow = network.recordFlow(engine, start, end, limit, *this);
+
+    complete = flow < limit;
+    workCounters = network.getWorkCounters();
+}
+
+int FlowCurve::pathsFor(int groupSize) const {
+    if (groupSize <= 0)
+        return 0;
+
+    auto it = std::lower_bound(breakpoints.begin(), breakpoints.end(),
+                               groupSize);
+    if (it == breakpoints.end())
+        return -1;
+
+    return it - breakpoints.begin() + 1;
+}
+
+template <typename F> void FlowCurve::replay(int groupSize, F send) const {
+    int flow = 0;
+
+    for (int path = 0; flow < groupSize; ++path) {
+        // the last path only sends what is still missing
+        int sent = std::min(breakpoints[path] - flow, groupSize - flow);
+        flow += sent;
+
+        for (int i = pathOffsets[path]; i < pathOffsets[path + 1]; ++i)
+            send(steps[i], steps[i].backward ? -sent : sent);
+    }
+}
+
+std::pair<int, Graph> FlowCurve::flowFor(int groupSize) const {
+    int flow = std::min(groupSize, getFlow());
+
+    // the flow and source node of every edge the paths go through
+    std::unordered_map<int, std::pair<int, int>> edges{};
+    replay(flow, [&](const Step &step, int sent) {
+        auto &[edgeFlow, src] = edges[step.edge];
+        edgeFlow += sent;
+        src = step.src;
+    });
+
+    Graph result{n};
+
+    for (const auto &[edge, value] : edges)
+        if (value.first > 0)
+            result.addEdge(value.second, graph.getDest(edge),
+                           graph.getCapacity(edge), graph.getDuration(edge));
+
+    return {flow, result};
+}
+
+ResidualNetwork FlowCurve::networkFor(int groupSize) const {
+    ResidualNetwork network{graph};
+    replay(groupSize, [&](const Step &step, int sent) {
+        network.sendFlow(step.edge, sent);
+    });
+
+    return network;
+}
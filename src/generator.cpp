@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <functional>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <unordered_set>
+
+#include "../includes/generator.hpp"
+
+/**
+ * @brief How many source nodes are in each chunk, for the topologies that are
+ *        generated node by node.
+ */
+static const int CHUNK_NODES = 1 << 12;
+/**
+ * @brief How many edges are in each chunk, for the topologies that are
+ *        generated edge by edge.
+ */
+static const int CHUNK_EDGES = 1 << 16;
+
+/**
+ * @brief Creates the random generator of a chunk.
+ */
+static std::mt19937_64 chunkGenerator(uint64_t seed, int chunk) {
+    std::seed_seq seq{(uint32_t)seed, (uint32_t)(seed >> 32), (uint32_t)chunk};
+    return std::mt19937_64{seq};
+}
+
+/**
+ * @brief Creates an edge with a random capacity and duration.
+ */
+static CsrEdge randomEdge(const DatasetGenerationParams &params, int src,
+                          int dest, std::mt19937_64 &gen) {
+    std::uniform_int_distribution capacity{params.minEdgeCapacity,
+                                           params.maxEdgeCapacity},
+        duration{params.minEdgeDuration, params.maxEdgeDuration};
+
+    return {src, dest, (int)capacity(gen), (int)duration(gen)};
+}
+
+/**
+ * @brief Picks k distinct numbers from 0 to n - 1 with Floyd's algorithm, in a
+ *        random order.
+ *
+ * @details Takes k steps and k memory, without going through all the other
+ *          numbers.
+ */
+static std::vector<uint64_t> sampleDistinct(uint64_t n, uint64_t k,
+                                            std::mt19937_64 &gen) {
+    std::unordered_set<uint64_t> picked{};
+    std::vector<uint64_t> sample{};
+    picked.reserve(k);
+    sample.reserve(k);
+
+    for (uint64_t j = n - k; j < n; ++j) {
+        uint64_t number = std::uniform_int_distribution<uint64_t>{0, j}(gen);
+
+        if (!picked.insert(number).second) {
+            number = j;
+            picked.insert(number);
+        }
+
+        sample.push_back(number);
+    }
+
+    // Floyd's algorithm doesn't pick them in a random order
+    std::shuffle(sample.begin(), sample.end(), gen);
+
+    return sample;
+}
+
+/**
+ * @brief Counts the pairs of nodes i < j before row i, when the pairs of a
+ *        graph with n nodes are numbered from 0, row by row: (1, 2), ...,
+ *        (1, n), (2, 3)...
+ */
+static uint64_t pairsBefore(int n, uint64_t i) {
+    // row i has the n - i pairs (i, i + 1) to (i, n)
+    return (i - 1) * (2 * n - i) / 2;
+}
+
+/**
+ * @brief Finds the nodes i < j of a pair, numbered like in pairsBefore().
+ */
+static std::pair<int, int> pairNodes(int n, uint64_t pair) {
+    double b = 2.0 * n - 1;
+    uint64_t i = 1 + (uint64_t)((b - std::sqrt(b * b - 8.0 * pair)) / 2);
+    i = std::clamp<uint64_t>(i, 1, n - 1);
+
+    // the square root may be off by one either way
+    while (i > 1 && pairsBefore(n, i) > pair)
+        --i;
+    while (i < (uint64_t)n - 1 && pairsBefore(n, i + 1) <= pair)
+        ++i;
+
+    return {i, i + 1 + (pair - pairsBefore(n, i))};
+}
+
+std::vector<CsrEdge> generateEdges(const DatasetGenerationParams &params) {
+    int n = params.numberOfNodes;
+    uint64_t k = std::max(params.numberOfEdges, 0);
+
+    if (n < 2)
+        return {};
+
+    // the chunks of node by node topologies hold the nodes from
+    // 1 + c * CHUNK_NODES, and no topology has edges leaving n
+    int chunks = (n - 2) / CHUNK_NODES + 1;
+    std::function<void(int, std::mt19937_64 &, std::vector<CsrEdge> &)>
+        makeChunk;
+
+    auto forEachNode = [n](int chunk, auto f) {
+        int first = 1 + chunk * CHUNK_NODES;
+        int last = std::min(n - 1, first + CHUNK_NODES - 1);
+
+        for (int u = first; u <= last; ++u)
+            f(u);
+    };
+
+    // shared by the chunks, which only read them
+    std::vector<int> layerStarts{};
+    std::vector<double> aliasProbabilities{};
+    std::vector<int> aliases{};
+    std::vector<char> isRung{};
+
+    switch (params.topology) {
+    case Topology::UNIFORM: {
+        uint64_t pairs = pairsBefore(n, n);
+        k = std::min(k, pairs);
+
+        // every chunk gets its share of the edges, so the total is exact
+        auto share = [=](uint64_t before) {
+            return (uint64_t)((long double)k * before / pairs);
+        };
+
+        makeChunk = [=](int chunk, std::mt19937_64 &gen,
+                        std::vector<CsrEdge> &edges) {
+            uint64_t first = 1 + (uint64_t)chunk * CHUNK_NODES;
+            uint64_t last = std::min<uint64_t>(n, first + CHUNK_NODES);
+            uint64_t begin = pairsBefore(n, first), end = pairsBefore(n, last);
+
+            for (uint64_t pair :
+                 sampleDistinct(end - begin, share(end) - share(begin), gen)) {
+                auto [src, dest] = pairNodes(n, begin + pair);
+                edges.push_back(randomEdge(params, src, dest, gen));
+            }
+        };
+        break;
+    }
+
+    case Topology::LAYERED: {
+        int middle = n - 2;
+        int layers = std::max(1, (int)std::sqrt(middle));
+
+        for (int l = 0; l <= layers; ++l)
+            layerStarts.push_back(2 + (int64_t)l * middle / layers);
+
+        // what is left after leaving the first node and entering the last is
+        // split between the nodes that have a next layer
+        int64_t sources = layerStarts[layers - 1] - 2;
+        int64_t budget = (int64_t)k - (layerStarts[1] - 2) -
+                         (n - layerStarts[layers - 1]);
+        int64_t degree =
+            sources == 0 ? 0 : std::max<int64_t>(1, budget / sources);
+
+        makeChunk = [&, n, middle, layers, degree](
+                        int chunk, std::mt19937_64 &gen,
+                        std::vector<CsrEdge> &edges) {
+            forEachNode(chunk, [&](int u) {
+                if (u == 1) {
+                    for (int v = 2; v < layerStarts[1]; ++v)
+                        edges.push_back(randomEdge(params, u, v, gen));
+
+                    if (middle == 0)
+                        edges.push_back(randomEdge(params, u, n, gen));
+
+                    return;
+                }
+
+                int l = std::upper_bound(layerStarts.begin(), layerStarts.end(),
+                                         u) -
+                        layerStarts.begin() - 1;
+
+                if (l == layers - 1) {
+                    edges.push_back(randomEdge(params, u, n, gen));
+                    return;
+                }
+
+                int first = layerStarts[l + 1];
+                int size = layerStarts[l + 2] - first;
+
+                for (uint64_t v :
+                     sampleDistinct(size, std::min<int64_t>(degree, size), gen))
+                    edges.push_back(randomEdge(params, u, first + v, gen));
+            });
+        };
+        break;
+    }
+
+    case Topology::GRID: {
+        int width = std::ceil(std::sqrt(n));
+
+        makeChunk = [=](int chunk, std::mt19937_64 &gen,
+                        std::vector<CsrEdge> &edges) {
+            forEachNode(chunk, [&](int u) {
+                if (u % width != 0)
+                    edges.push_back(randomEdge(params, u, u + 1, gen));
+                if (u + width <= n)
+                    edges.push_back(randomEdge(params, u, u + width, gen));
+            });
+        };
+        break;
+    }
+
+    case Topology::POWER_LAW: {
+        // Chung-Lu weights, for degrees that follow a power law with an
+        // exponent of 2.5, sampled in constant time with Walker's alias method
+        std::vector<double> weights(n + 1);
+        double total = 0;
+        for (int i = 1; i <= n; ++i)
+            total += weights[i] = std::pow(i, -2.0 / 3);
+
+        aliasProbabilities.assign(n + 1, 1);
+        aliases.resize(n + 1);
+        std::iota(aliases.begin(), aliases.end(), 0);
+
+        std::vector<int> small{}, large{};
+        for (int i = 1; i <= n; ++i) {
+            weights[i] *= n / total;
+            (weights[i] < 1 ? small : large).push_back(i);
+        }
+
+        // each node gives what its weight lacks to a node with too much
+        while (!small.empty() && !large.empty()) {
+            int lacking = small.back(), giving = large.back();
+            small.pop_back();
+
+            aliasProbabilities[lacking] = weights[lacking];
+            aliases[lacking] = giving;
+
+            weights[giving] -= 1 - weights[lacking];
+            if (weights[giving] < 1) {
+                large.pop_back();
+                small.push_back(giving);
+            }
+        }
+
+        chunks = (k + CHUNK_EDGES - 1) / CHUNK_EDGES;
+
+        makeChunk = [&, n, k](int chunk, std::mt19937_64 &gen,
+                              std::vector<CsrEdge> &edges) {
+            std::uniform_int_distribution node{1, n};
+            std::uniform_real_distribution<double> coin{0, 1};
+
+            auto pick = [&]() {
+                int u = node(gen);
+                return coin(gen) < aliasProbabilities[u] ? u : aliases[u];
+            };
+
+            uint64_t count = std::min<uint64_t>(
+                CHUNK_EDGES, k - (uint64_t)chunk * CHUNK_EDGES);
+
+            for (uint64_t i = 0; i < count; ++i) {
+                int a = pick(), b = pick();
+                while (a == b)
+                    b = pick();
+
+                edges.push_back(
+                    randomEdge(params, std::min(a, b), std::max(a, b), gen));
+            }
+        };
+        break;
+    }
+
+    case Topology::LONG_CHAIN:
+    default: {
+        // rungs go through nodes 3 to n - 2, so they never repeat the chain
+        int64_t rungs = std::clamp<int64_t>(((int64_t)k - (n - 1)) / 2, 0,
+                                            std::max(0, n - 4));
+
+        isRung.assign(n + 1, false);
+        for (int64_t j = 0; j < rungs; ++j)
+            isRung[3 + j * (n - 4) / rungs] = true;
+
+        makeChunk = [&, n](int chunk, std::mt19937_64 &gen,
+                           std::vector<CsrEdge> &edges) {
+            auto edge = [&](int src, int dest, int capacity) {
+                CsrEdge e = randomEdge(params, src, dest, gen);
+                e.capacity = capacity;
+                edges.push_back(e);
+            };
+
+            forEachNode(chunk, [&](int u) {
+                edge(u, u + 1, params.maxEdgeCapacity);
+
+                if (u == 1)
+                    for (int v = 3; v <= n - 2; ++v)
+                        if (isRung[v])
+                            edge(u, v, params.minEdgeCapacity);
+
+                if (isRung[u])
+                    edge(u, n, params.minEdgeCapacity);
+            });
+        };
+        break;
+    }
+    }
+
+    std::vector<std::vector<CsrEdge>> chunkEdges(chunks);
+    std::atomic<int> nextChunk{0};
+
+    auto worker = [&]() {
+        for (int c = nextChunk++; c < chunks; c = nextChunk++) {
+            auto gen = chunkGenerator(params.seed, c);
+            makeChunk(c, gen, chunkEdges[c]);
+        }
+    };
+
+    unsigned threads = params.threads;
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::min<unsigned>(threads, chunks);
+
+    std::vector<std::thread> workers{};
+    for (unsigned i = 1; i < threads; ++i)
+        workers.emplace_back(worker);
+
+    worker();
+
+    for (auto &w : workers)
+        w.join();
+
+    std::vector<CsrEdge> edges{};
+    for (auto &chunk : chunkEdges) {
+        edges.insert(edges.end(), chunk.begin(), chunk.end());
+        std::vector<CsrEdge>{}.swap(chunk);
+    }
+
+    if (params.topology != Topology::POWER_LAW)
+        return edges;
+
+    // random pairs may repeat, only the first of each is kept, found by
+    // sorting them with their positions since a hash set is much slower
+    std::vector<std::pair<uint64_t, size_t>> pairs(edges.size());
+    for (size_t i = 0; i < edges.size(); ++i)
+        pairs[i] = {(uint64_t)edges[i].src << 32 | edges[i].dest, i};
+
+    std::sort(pairs.begin(), pairs.end());
+
+    std::vector<bool> repeated(edges.size());
+    for (size_t i = 1; i < pairs.size(); ++i)
+        if (pairs[i].first == pairs[i - 1].first)
+            repeated[pairs[i].second] = true;
+
+    size_t kept = 0;
+    for (size_t i = 0; i < edges.size(); ++i)
+        if (!repeated[i])
+            edges[kept++] = edges[i];
+
+    edges.resize(kept);
+    return edges;
+}
@@ -0,0 +1,155 @@
+#include <spawn.h>
+#include <sys/wait.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+#include <unordered_map>
+
+#include "../includes/graphviz.hpp"
+#include "../includes/mapped_file.hpp"
+#include "../includes/tracer.hpp"
+
+extern char **environ;
+
+/**
+ * @brief The command the dot files are laid out with, also hashed so that
+ *        changing it renders everything again.
+ */
+static const std::vector<std::string> LAYOUT_COMMAND{"sfdp", "-T", "svg"};
+
+/**
+ * @brief Hashes a dot file with FNV-1a.
+ *
+ * @param path The path of the dot file.
+ * @return The hash, in hexadecimal, or an empty string if the file can't be
+ *         read.
+ */
+static std::string hashDotFile(const std::string &path) {
+    MappedFile file{path};
+
+    if (!file.isOpen())
+        return "";
+
+    uint64_t hash = 14695981039346656037ull;
+    auto add = [&hash](std::string_view bytes) {
+        for (unsigned char byte : bytes) {
+            hash ^= byte;
+            hash *= 1099511628211ull;
+        }
+    };
+
+    for (const std::string &arg : LAYOUT_COMMAND)
+        add({arg.c_str(), arg.size() + 1});
+    add(file.getContents());
+
+    char hex[17];
+    snprintf(hex, sizeof hex, "%016llx", (unsigned long long)hash);
+    return hex;
+}
+
+/**
+ * @brief Starts laying out a dot file.
+ *
+ * @param job The dot file and its svg.
+ * @return The id of the process, or -1 if it couldn't be started.
+ */
+static pid_t startLayout(const RenderJob &job) {
+    std::vector<std::string> args{LAYOUT_COMMAND};
+    args.insert(args.end(), {"-o", job.svgPath, job.dotPath});
+
+    std::vector<char *> argv{};
+    for (std::string &arg : args)
+        argv.push_back(arg.data());
+    argv.push_back(nullptr);
+
+    pid_t pid;
+    if (posix_spawnp(&pid, argv[0], nullptr, nullptr, argv.data(), environ))
+        return -1;
+
+    return pid;
+}
+
+std::vector<bool> renderDotFiles(const std::vector<RenderJob> &jobs,
+                                 unsigned workers) {
+    std::vector<bool> ready(jobs.size(), false);
+    std::vector<std::string> hashes(jobs.size());
+    std::vector<long long> started(jobs.size());
+
+    if (workers == 0)
+        workers = std::max(std::thread::hardware_concurrency(), 1u);
+
+    // the job each running process belongs to
+    std::unordered_map<pid_t, size_t> running{};
+
+    auto finish = [&](size_t i, bool succeeded) {
+        if (Tracer::isEnabled())
+            Tracer::record("layout process", started[i], Tracer::now(), "job",
+                           i);
+
+        ready[i] = succeeded;
+
+        std::string hashPath = jobs[i].svgPath + ".hash";
+        if (ready[i])
+            std::ofstream{hashPath} << hashes[i] << '\n';
+        else
+            std::filesystem::remove(hashPath);
+    };
+
+    // only the processes started here are waited for, so that the exit status
+    // of any other child of the program is left alone
+    auto waitForOne = [&]() {
+        while (true) {
+            for (auto it = running.begin(); it != running.end(); ++it) {
+                int status;
+                pid_t pid = waitpid(it->first, &status, WNOHANG);
+
+                if (pid == 0 || (pid == -1 && errno == EINTR))
+                    continue;
+
+                size_t i = it->second;
+                running.erase(it);
+
+                // a process that can't be waited for anymore is lost
+                finish(i, pid != -1 && WIFEXITED(status) &&
+                              WEXITSTATUS(status) == 0);
+                return;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds{5});
+        }
+    };
+
+    for (size_t i = 0; i < jobs.size(); ++i) {
+        hashes[i] = hashDotFile(jobs[i].dotPath);
+
+        if (hashes[i].empty())
+            continue;
+
+        std::string cached{};
+        std::ifstream{jobs[i].svgPath + ".hash"} >> cached;
+
+        if (cached == hashes[i] && std::filesystem::exists(jobs[i].svgPath)) {
+            ready[i] = true;
+            continue;
+        }
+
+        while (running.size() >= workers)
+            waitForOne();
+
+        started[i] = Tracer::now();
+        pid_t pid = startLayout(jobs[i]);
+        if (pid != -1)
+            running.insert({pid, i});
+    }
+
+    while (!running.empty())
+        waitForOne();
+
+    return ready;
+}
@@ -0,0 +1,42 @@
+#include <algorithm>
+#include <bit>
+
+#include "../includes/latency_histogram.hpp"
+
+void LatencyHistogram::record(std::chrono::microseconds latency) {
+    uint64_t us = std::max<int64_t>(latency.count(), 0);
+    int bucket = std::min<int>(std::bit_width(us), BUCKETS - 1);
+
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+std::string LatencyHistogram::summary() const {
+    std::array<uint64_t, BUCKETS> snapshot{};
+    uint64_t total = 0;
+
+    for (int b = 0; b < BUCKETS; ++b)
+        total += snapshot[b] = counts[b].load(std::memory_order_relaxed);
+
+    std::string result = "n=" + std::to_string(total);
+
+    if (total == 0)
+        return result;
+
+    // the bucket that holds the latency with the given rank, from 1 to total
+    auto bound = [&](uint64_t rank) {
+        uint64_t seen = 0;
+        int b = 0;
+
+        while ((seen += snapshot[b]) < rank)
+            ++b;
+
+        return std::to_string(uint64_t{1} << b) + "us";
+    };
+
+    result += " p50<=" + bound((total + 1) / 2);
+    result += " p90<=" + bound((total * 9 + 9) / 10);
+    result += " p99<=" + bound((total * 99 + 99) / 100);
+    result += " max<=" + bound(total);
+
+    return result;
+}
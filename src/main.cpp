@@ -1,13 +1,26 @@
+#include <cstdlib>
 #include <filesystem>
 #include <iostream>
 #include <set>
 
+#include "../includes/batch.hpp"
 #include "../includes/constants.hpp"
 #include "../includes/dataset.hpp"
+#include "../includes/server.hpp"
+#include "../includes/tracer.hpp"
 #include "../includes/ui.hpp"
 #include "../includes/utils.hpp"
 
 int main(int argc, char **argv) {
+    if (const char *trace = std::getenv(TRACE_VARIABLE.c_str()))
+        Tracer::enable(trace);
+
+    // with arguments, the scenarios are run without ever touching the terminal
+    if (argc > 1 && std::string{argv[1]} == "--serve")
+        return runServer(argc, argv);
+    if (argc > 1)
+        return runBatch(argc, argv);
+
     UserInterface ui{};
 
     Dataset dataset = Dataset::load("in01_b.txt");
@@ -0,0 +1,38 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "../includes/mapped_file.hpp"
+
+MappedFile::MappedFile(const std::string &path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+
+    if (fd == -1)
+        return;
+
+    open = true;
+
+    struct stat info {};
+
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void *mapped =
+            mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+
+        if (mapped != MAP_FAILED) {
+            data = static_cast<const char *>(mapped);
+            size = info.st_size;
+
+            // the file is read from start to end once
+            madvise(mapped, size, MADV_SEQUENTIAL);
+        }
+    }
+
+    // the mapping stays valid after the file is closed
+    close(fd);
+}
+
+MappedFile::~MappedFile() {
+    if (data != nullptr)
+        munmap(const_cast<char *>(data), size);
+}
@@ -0,0 +1,103 @@
+#include "../includes/memory_tracker.hpp"
+
+#ifdef ALLOCATION_TRACKING
+
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+/**
+ * @brief How many bytes the current thread has allocated with new.
+ */
+static thread_local long long allocatedBytes = 0;
+/**
+ * @brief How many times the current thread has called new.
+ */
+static thread_local long long allocationCount = 0;
+
+void *operator new(std::size_t size) {
+    allocatedBytes += size;
+    ++allocationCount;
+
+    if (size == 0)
+        size = 1;
+
+    while (true) {
+        if (void *ptr = std::malloc(size))
+            return ptr;
+
+        std::new_handler handler = std::get_new_handler();
+
+        if (handler == nullptr)
+            throw std::bad_alloc{};
+
+        handler();
+    }
+}
+
+void operator delete(void *ptr) noexcept { std::free(ptr); }
+
+void operator delete(void *ptr, std::size_t) noexcept { std::free(ptr); }
+
+/**
+ * @brief Reads the peak resident set size of this process.
+ *
+ * @details Only goes through system calls, so that it doesn't allocate
+ *          anything itself.
+ *
+ * @return The peak resident set size in bytes, or -1 if it isn't reported.
+ */
+static long long readPeakRss() {
+    int fd = ::open("/proc/self/status", O_RDONLY);
+
+    if (fd == -1)
+        return -1;
+
+    char buffer[8192];
+    ssize_t size = read(fd, buffer, sizeof(buffer) - 1);
+    close(fd);
+
+    if (size <= 0)
+        return -1;
+
+    buffer[size] = '\0';
+    const char *line = std::strstr(buffer, "VmHWM:");
+
+    if (line == nullptr)
+        return -1;
+
+    // the value is in kB
+    return std::strtoll(line + 6, nullptr, 10) * 1024;
+}
+
+void MemoryTracker::start() {
+    // 5 resets the peak resident set size to the current one
+    int fd = ::open("/proc/self/clear_refs", O_WRONLY);
+
+    // if it can't be reset, the peak is the one since the program started
+    if (fd != -1) {
+        [[maybe_unused]] ssize_t written = write(fd, "5", 1);
+        close(fd);
+    }
+
+    startBytes = allocatedBytes;
+    startAllocations = allocationCount;
+}
+
+MemorySample MemoryTracker::stop() const {
+    long long bytes = allocatedBytes - startBytes;
+    long long allocations = allocationCount - startAllocations;
+
+    return {bytes, allocations, readPeakRss()};
+}
+
+#else
+
+void MemoryTracker::start() {}
+
+MemorySample MemoryTracker::stop() const { return {}; }
+
+#endif
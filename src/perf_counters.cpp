@@ -0,0 +1,120 @@
+#include "../includes/perf_counters.hpp"
+
+#if defined(PERF_COUNTERS) && defined(__linux__)
+
+#include <cstdint>
+#include <utility>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+/**
+ * @brief The type and config of each counter, in the order of the fields of
+ *        PerfSample.
+ */
+static constexpr std::array<std::pair<uint32_t, uint64_t>, 5> EVENTS{{
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS},
+}};
+
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+    positions.fill(-1);
+
+    for (int i = 0; i < COUNTERS; ++i) {
+        perf_event_attr attr{};
+        attr.size = sizeof(attr);
+        attr.type = EVENTS[i].first;
+        attr.config = EVENTS[i].second;
+        attr.disabled = leader == -1;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                           PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+        // the first counter that opens leads the group, so a missing hardware
+        // counter doesn't take the others with it
+        int fd = syscall(SYS_perf_event_open, &attr, 0, -1, leader, 0);
+
+        if (fd == -1)
+            continue;
+
+        if (leader == -1)
+            leader = fd;
+
+        fds[i] = fd;
+        positions[i] = opened++;
+    }
+}
+
+PerfCounters::~PerfCounters() {
+    for (int fd : fds)
+        if (fd != -1)
+            close(fd);
+}
+
+void PerfCounters::start() {
+    if (leader == -1)
+        return;
+
+    ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+}
+
+PerfSample PerfCounters::stop() {
+    if (leader == -1)
+        return {};
+
+    ioctl(leader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+    // nr, time enabled, time running and then the value of each counter
+    uint64_t buffer[3 + COUNTERS]{};
+    ssize_t expected = (3 + opened) * sizeof(uint64_t);
+
+    if (read(leader, buffer, sizeof(buffer)) < expected)
+        return {};
+
+    uint64_t enabled = buffer[1], running = buffer[2];
+    std::array<long long, COUNTERS> values{};
+
+    for (int i = 0; i < COUNTERS; ++i) {
+        if (positions[i] == -1 || running == 0) {
+            values[i] = -1;
+            continue;
+        }
+
+        uint64_t value = buffer[3 + positions[i]];
+
+        if (running < enabled)
+            value = (long double)value * enabled / running;
+
+        values[i] = value;
+    }
+
+    return {values[0], values[1], values[2], values[3], values[4]};
+}
+
+#else
+
+PerfCounters::PerfCounters() {
+    fds.fill(-1);
+    positions.fill(-1);
+}
+
+PerfCounters::~PerfCounters() {}
+
+void PerfCounters::start() {}
+
+PerfSample PerfCounters::stop() { return {}; }
+
+#endif
+
+PerfCounters &PerfCounters::forThisThread() {
+    thread_local PerfCounters counters{};
+    return counters;
+}
@@ -0,0 +1,584 @@
+#include <algorithm>
+#include <queue>
+
+#include "../includes/flow_curve.hpp"
+#include "../includes/residual_network.hpp"
+#include "../includes/tracer.hpp"
+
+std::optional<FlowEngine> parseFlowEngine(const std::string &name) {
+    if (name == "edmonds-karp")
+        return FlowEngine::EDMONDS_KARP;
+    if (name == "dinic")
+        return FlowEngine::DINIC;
+    if (name == "push-relabel")
+        return FlowEngine::PUSH_RELABEL;
+
+    return {};
+}
+
+ResidualNetwork::ResidualNetwork(const CsrGraph &graph)
+    : graph(graph), n(graph.getN()) {
+    TraceSpan span{"ResidualNetwork::ResidualNetwork"};
+
+    int m = graph.getEdgeCount();
+
+    // every node has its outgoing edges plus the reverse of its incoming ones
+    offsets.assign(n + 2, 0);
+
+    for (int src = 1; src <= n; ++src) {
+        offsets[src + 1] += graph.edgesEnd(src) - graph.edgesBegin(src);
+
+        for (int e = graph.edgesBegin(src); e < graph.edgesEnd(src); ++e)
+            ++offsets[graph.getDest(e) + 1];
+    }
+
+    for (int i = 1; i <= n + 1; ++i)
+        offsets[i] += offsets[i - 1];
+
+    heads.resize(2 * m);
+    residual.resize(2 * m);
+    reverse.resize(2 * m);
+    edges.resize(2 * m);
+    forwardArcs.resize(m);
+
+    std::vector<int> next{offsets.begin(), offsets.end() - 1};
+
+    for (int src = 1; src <= n; ++src) {
+        for (int e = graph.edgesBegin(src); e < graph.edgesEnd(src); ++e) {
+            int dest = graph.getDest(e);
+            int forward = next[src]++, backward = next[dest]++;
+
+            heads[forward] = dest;
+            residual[forward] = graph.getCapacity(e);
+            reverse[forward] = backward;
+            edges[forward] = e;
+
+            heads[backward] = src;
+            residual[backward] = 0;
+            reverse[backward] = forward;
+            edges[backward] = -1;
+
+            forwardArcs[e] = forward;
+        }
+    }
+
+    level.assign(n + 1, -1);
+    currentArc.assign(n + 1, 0);
+}
+
+int ResidualNetwork::edmondsKarpBFS(int s, int t) {
+    workspace.reset(n);
+    COUNT_WORK(++workCounters.bfsPasses);
+
+    std::queue<std::pair<int, int>> q;
+
+    q.push({s, INT_MAX});
+    workspace.visit(s);
+
+    while (!q.empty()) {
+        auto [cur, flow] = q.front();
+        q.pop();
+        COUNT_WORK(++workCounters.nodesDequeued);
+
+        for (int a = offsets[cur]; a < offsets[cur + 1]; ++a) {
+            int dest = heads[a];
+            COUNT_WORK(++workCounters.arcsScanned);
+
+            if (!workspace.isVisited(dest) && residual[a] > 0) {
+                workspace.visit(dest, cur, a);
+                int new_flow = std::min(flow, residual[a]);
+
+                if (dest == t)
+                    return new_flow;
+
+                q.push({dest, new_flow});
+            }
+        }
+    }
+
+    return -1;
+}
+
+int ResidualNetwork::edmondsKarp(int start, int end, int groupSize) {
+    int flow = 0, new_flow = 0;
+
+    for (int iteration = 0; flow < groupSize; ++iteration) {
+        TraceSpan span{"edmondsKarp iteration", "iteration", iteration};
+
+        new_flow = edmondsKarpBFS(start, end);
+
+        if (new_flow == -1)
+            break;
+
+        if (curve != nullptr) {
+            for (int v = end; v != start;) {
+                int a = workspace.getParentEdge(v);
+                recordStep(a);
+                v = heads[reverse[a]];
+            }
+
+            curve->endPath(new_flow);
+        }
+
+        // don't send more than what was asked for
+        new_flow = std::min(new_flow, groupSize - flow);
+        flow += new_flow;
+        COUNT_WORK(workCounters.augment(new_flow));
+
+        int cur = end;
+
+        while (cur != start) {
+            int a = workspace.getParentEdge(cur);
+            recordChange(a);
+            residual[a] -= new_flow;
+            residual[reverse[a]] += new_flow;
+            cur = heads[reverse[a]];
+        }
+    }
+
+    return flow;
+}
+
+bool ResidualNetwork::dinicBFS(int s, int t) {
+    std::fill(level.begin(), level.end(), -1);
+    COUNT_WORK(++workCounters.bfsPasses);
+
+    level[s] = 0;
+    frontier.assign(1, s);
+
+    // every arc has its reverse in the other node, so top-down and bottom-up
+    // both walk the same arcs. Nodes cut off by saturated arcs are scanned
+    // whole in every bottom-up level, so it is only used while it can't check
+    // more arcs than top-down would
+    bool bottomUp = false;
+    long frontierSize = 1, frontierArcs = offsets[s + 1] - offsets[s],
+         unvisitedArcs = heads.size() - frontierArcs;
+
+    // the whole level of t is found, like the nodes further away than t, they
+    // can't be in a shortest path
+    for (int depth = 0; frontierSize > 0 && level[t] == -1; ++depth) {
+        if (!bottomUp && frontierArcs > unvisitedArcs) {
+            frontierBits.clear(n);
+            for (int node : frontier)
+                frontierBits.set(node);
+
+            bottomUp = true;
+        } else if (bottomUp && frontierArcs <= unvisitedArcs) {
+            frontier.clear();
+            for (int node = 1; node <= n; ++node)
+                if (level[node] == depth)
+                    frontier.push_back(node);
+
+            bottomUp = false;
+        }
+
+        frontierSize = frontierArcs = 0;
+
+        if (bottomUp) {
+            nextFrontierBits.clear(n);
+
+            for (int node = 1; node <= n; ++node) {
+                if (level[node] != -1)
+                    continue;
+
+                COUNT_WORK(++workCounters.nodesDequeued);
+
+                for (int a = offsets[node]; a < offsets[node + 1]; ++a) {
+                    COUNT_WORK(++workCounters.arcsScanned);
+
+                    if (residual[reverse[a]] > 0 &&
+                        frontierBits.test(heads[a])) {
+                        level[node] = depth + 1;
+                        nextFrontierBits.set(node);
+
+                        ++frontierSize;
+                        frontierArcs += offsets[node + 1] - offsets[node];
+                        break;
+                    }
+                }
+            }
+
+            frontierBits.swap(nextFrontierBits);
+        } else {
+            nextFrontier.clear();
+
+            for (int cur : frontier) {
+                COUNT_WORK(++workCounters.nodesDequeued);
+
+                for (int a = offsets[cur]; a < offsets[cur + 1]; ++a) {
+                    int dest = heads[a];
+                    COUNT_WORK(++workCounters.arcsScanned);
+
+                    if (level[dest] == -1 && residual[a] > 0) {
+                        level[dest] = depth + 1;
+                        nextFrontier.push_back(dest);
+                        frontierArcs += offsets[dest + 1] - offsets[dest];
+                    }
+                }
+            }
+
+            frontier.swap(nextFrontier);
+            frontierSize = frontier.size();
+        }
+
+        unvisitedArcs -= frontierArcs;
+    }
+
+    return level[t] != -1;
+}
+
+int ResidualNetwork::dinicBlockingFlow(int s, int t, int limit) {
+    for (int i = 1; i <= n; ++i)
+        currentArc[i] = offsets[i];
+
+    // the arcs of the path being built, walked without recursion so that
+    // long paths can't overflow the stack
+    std::vector<int> path{};
+    int flow = 0, cur = s;
+
+    while (flow < limit) {
+        if (cur == t) {
+            int new_flow = limit - flow;
+            for (int a : path)
+                new_flow = std::min(new_flow, residual[a]);
+
+            if (curve != nullptr) {
+                int bottleneck = INT_MAX;
+                for (int a : path) {
+                    bottleneck = std::min(bottleneck, residual[a]);
+                    recordStep(a);
+                }
+
+                curve->endPath(bottleneck);
+            }
+
+            flow += new_flow;
+            COUNT_WORK(workCounters.augment(new_flow));
+
+            // go back to the tail of the first saturated arc
+            int saturated = -1;
+            for (int i = 0; i < (int)path.size(); ++i) {
+                recordChange(path[i]);
+                residual[path[i]] -= new_flow;
+                residual[reverse[path[i]]] += new_flow;
+
+                if (saturated == -1 && residual[path[i]] == 0)
+                    saturated = i;
+            }
+
+            if (saturated == -1)
+                break;
+
+            cur = heads[reverse[path[saturated]]];
+            path.resize(saturated);
+            continue;
+        }
+
+        int &a = currentArc[cur];
+        COUNT_WORK(int first = a);
+
+        while (a < offsets[cur + 1] &&
+               (residual[a] == 0 || level[heads[a]] != level[cur] + 1))
+            ++a;
+
+        COUNT_WORK(workCounters.arcsScanned +=
+                   a - first + (a < offsets[cur + 1]));
+
+        if (a < offsets[cur + 1]) {
+            path.push_back(a);
+            cur = heads[a];
+        } else {
+            // dead end, nothing else can go through this node in this phase
+            level[cur] = -1;
+
+            if (cur == s)
+                break;
+
+            cur = heads[reverse[path.back()]];
+            path.pop_back();
+            ++currentArc[cur];
+        }
+    }
+
+    return flow;
+}
+
+int ResidualNetwork::dinic(int start, int end, int groupSize) {
+    int flow = 0;
+
+    for (int phase = 0; flow < groupSize; ++phase) {
+        TraceSpan span{"dinic phase", "phase", phase};
+
+        if (!dinicBFS(start, end))
+            break;
+
+        flow += dinicBlockingFlow(start, end, groupSize - flow);
+    }
+
+    return flow;
+}
+
+void ResidualNetwork::activate(int v) {
+    activeNext[v] = activeHead[height[v]];
+    activeHead[height[v]] = v;
+    maxActive = std::max(maxActive, height[v]);
+}
+
+void ResidualNetwork::addToLayer(int v) {
+    int h = height[v];
+
+    layerPrev[v] = -1;
+    layerNext[v] = layerHead[h];
+    if (layerHead[h] != -1)
+        layerPrev[layerHead[h]] = v;
+    layerHead[h] = v;
+
+    maxLayer = std::max(maxLayer, h);
+}
+
+void ResidualNetwork::removeFromLayer(int v) {
+    if (layerPrev[v] != -1)
+        layerNext[layerPrev[v]] = layerNext[v];
+    else
+        layerHead[height[v]] = layerNext[v];
+
+    if (layerNext[v] != -1)
+        layerPrev[layerNext[v]] = layerPrev[v];
+}
+
+void ResidualNetwork::globalRelabel(int s, int t) {
+    std::fill(height.begin(), height.end(), 2 * n);
+    std::fill(activeHead.begin(), activeHead.end(), -1);
+    std::fill(layerHead.begin(), layerHead.end(), -1);
+    maxActive = maxLayer = -1;
+    work = 0;
+
+    // walks the residual network backwards from the given node, labeling the
+    // nodes that don't have a height yet
+    auto bfs = [&](int root, int rootHeight) {
+        std::queue<std::pair<int, int>> q;
+        COUNT_WORK(++workCounters.bfsPasses);
+
+        q.push({root, rootHeight});
+        if (height[root] == 2 * n)
+            height[root] = rootHeight;
+
+        while (!q.empty()) {
+            auto [cur, h] = q.front();
+            q.pop();
+            COUNT_WORK(++workCounters.nodesDequeued);
+
+            for (int a = offsets[cur]; a < offsets[cur + 1]; ++a) {
+                int src = heads[a];
+                COUNT_WORK(++workCounters.arcsScanned);
+
+                if (height[src] == 2 * n && residual[reverse[a]] > 0) {
+                    height[src] = h + 1;
+                    q.push({src, h + 1});
+                }
+            }
+        }
+    };
+
+    bfs(t, 0);
+
+    // what can't reach the end goes back to the start
+    bfs(s, n);
+
+    for (int v = 1; v <= n; ++v) {
+        currentArc[v] = offsets[v];
+
+        if (height[v] < n)
+            addToLayer(v);
+        if (isActive(v, s, t))
+            activate(v);
+    }
+}
+
+void ResidualNetwork::relabel(int v, int s, int t) {
+    int old = height[v], newHeight = 2 * n;
+
+    if (old < n)
+        removeFromLayer(v);
+
+    for (int a = offsets[v]; a < offsets[v + 1]; ++a)
+        if (residual[a] > 0)
+            newHeight = std::min(newHeight, height[heads[a]] + 1);
+
+    work += offsets[v + 1] - offsets[v] + 12;
+    COUNT_WORK(++workCounters.relabels);
+    COUNT_WORK(workCounters.arcsScanned += offsets[v + 1] - offsets[v]);
+    currentArc[v] = offsets[v];
+
+    if (old < n && layerHead[old] == -1) {
+        // gap, nothing above the old height can reach the end anymore
+        for (int h = old + 1; h <= maxLayer; ++h) {
+            for (int w = layerHead[h]; w != -1; w = layerNext[w]) {
+                height[w] = n;
+                currentArc[w] = offsets[w];
+
+                if (isActive(w, s, t))
+                    activate(w);
+            }
+
+            layerHead[h] = -1;
+        }
+
+        maxLayer = old - 1;
+        newHeight = std::max(newHeight, n);
+    }
+
+    // the start never goes above n, so that excess can always go back to it
+    height[v] = std::min(newHeight, v == s ? n : 2 * n);
+
+    if (height[v] < n)
+        addToLayer(v);
+}
+
+void ResidualNetwork::discharge(int v, int s, int t) {
+    while (excess[v] > 0) {
+        if (currentArc[v] == offsets[v + 1]) {
+            relabel(v, s, t);
+
+            if (!isActive(v, s, t))
+                break;
+
+            continue;
+        }
+
+        int a = currentArc[v], w = heads[a];
+        COUNT_WORK(++workCounters.arcsScanned);
+
+        if (residual[a] > 0 && height[v] == height[w] + 1) {
+            int pushed = std::min(excess[v], residual[a]);
+            COUNT_WORK(++workCounters.pushes);
+            bool wasIdle = excess[w] == 0;
+
+            recordChange(a);
+            residual[a] -= pushed;
+            residual[reverse[a]] += pushed;
+            excess[v] -= pushed;
+            excess[w] += pushed;
+
+            if (wasIdle && isActive(w, s, t))
+                activate(w);
+        } else {
+            ++currentArc[v];
+        }
+    }
+}
+
+int ResidualNetwork::pushRelabel(int start, int end, int groupSize) {
+    // no more than what can leave the start can ever be sent
+    long long budget = 0;
+    for (int a = offsets[start]; a < offsets[start + 1]; ++a)
+        budget += residual[a];
+    budget = std::min<long long>(budget, groupSize);
+
+    if (budget == 0 || start == end)
+        return 0;
+
+    height.assign(n + 1, 2 * n);
+    excess.assign(n + 1, 0);
+    activeHead.assign(2 * n + 1, -1);
+    activeNext.assign(n + 1, -1);
+    layerHead.assign(n, -1);
+    layerNext.assign(n + 1, -1);
+    layerPrev.assign(n + 1, -1);
+
+    excess[start] = budget;
+    globalRelabel(start, end);
+
+    while (maxActive >= 0) {
+        int v = activeHead[maxActive];
+
+        if (v == -1) {
+            --maxActive;
+            continue;
+        }
+
+        activeHead[maxActive] = activeNext[v];
+        COUNT_WORK(++workCounters.nodesDequeued);
+
+        // nodes are left behind in their old height when they are lifted
+        if (height[v] != maxActive || !isActive(v, start, end))
+            continue;
+
+        discharge(v, start, end);
+
+        if (work > 6 * n + (long)heads.size())
+            globalRelabel(start, end);
+    }
+
+    return excess[end];
+}
+
+int ResidualNetwork::maxFlow(FlowEngine engine, int start, int end,
+                             int groupSize) {
+    switch (engine) {
+    case FlowEngine::DINIC:
+        return dinic(start, end, groupSize);
+    case FlowEngine::PUSH_RELABEL:
+        return pushRelabel(start, end, groupSize);
+    case FlowEngine::EDMONDS_KARP:
+    default:
+        return edmondsKarp(start, end, groupSize);
+    }
+}
+
+int ResidualNetwork::recordFlow(FlowEngine engine, int start, int end,
+                                int groupSize, FlowCurve &curve) {
+    this->curve = &curve;
+    int flow = maxFlow(pathEngine(engine), start, end, groupSize);
+    this->curve = nullptr;
+
+    return flow;
+}
+
+void ResidualNetwork::recordStep(int a) {
+    bool backward = edges[a] == -1;
+    int edge = backward ? edges[reverse[a]] : edges[a];
+
+    // the source of the edge is the tail of its forward arc
+    curve->addStep(edge, backward ? heads[a] : heads[reverse[a]], backward);
+}
+
+std::pair<int, Graph> ResidualNetwork::addFlow(FlowEngine engine, int start,
+                                               int end, int amount) {
+    changeStamps.resize(graph.getEdgeCount());
+    changes.clear();
+    ++changeEpoch;
+
+    recordingChanges = true;
+    int flow = maxFlow(engine, start, end, amount);
+    recordingChanges = false;
+
+    Graph delta{};
+
+    for (auto [edge, before] : changes) {
+        if (getFlow(edge) <= before)
+            continue;
+
+        int src = heads[reverse[forwardArcs[edge]]], dest = graph.getDest(edge);
+
+        delta.addNode(src);
+        delta.addNode(dest);
+
+        delta.addEdge(src, dest, graph.getCapacity(edge),
+                      graph.getDuration(edge));
+    }
+
+    return {flow, delta};
+}
+
+Graph ResidualNetwork::toGraph() const {
+    Graph result{n};
+
+    for (int src = 1; src <= n; ++src)
+        for (int e = graph.edgesBegin(src); e < graph.edgesEnd(src); ++e)
+            if (getFlow(e) > 0)
+                result.addEdge(src, graph.getDest(e), graph.getCapacity(e),
+                               graph.getDuration(e));
+
+    return result;
+}
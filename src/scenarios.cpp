@@ -1,225 +1,553 @@
 #include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <filesystem>
 #include <fstream>
 #include <iostream>
 #include <limits>
 #include <map>
+#include <mutex>
+#include <optional>
 #include <queue>
-#include <set>
 #include <sstream>
+#include <thread>
 
 #include "../includes/constants.hpp"
 #include "../includes/scenarios.hpp"
+#include "../includes/tracer.hpp"
+
+/**
+ * @brief Runs scenarios 2.1 to 2.3 with the given flow algorithm.
+ */
+static void runFlowScenarios(Dataset &dataset, int groupSize, int increase,
+                             FlowEngine engine) {
+    scenario2_1(dataset, groupSize, engine);
+    if (dataset.getScenario2Result().groupSize2_1 != -1)
+        scenario2_2(dataset, increase, engine);
+    scenario2_3(dataset, engine);
+}
 
-void runAllScenarios(int groupSize, int increase) {
-    std::ofstream out{OUTPUT_PATH + OUTPUT_FILE};
-    out << OUTPUT_HEADER;
-
-    for (const auto &name : Dataset::getAvailableDatasets()) {
-        Dataset dataset = Dataset::load(name);
-
-        auto &r1 = dataset.getScenario1Result();
-        auto &r2 = dataset.getScenario2Result();
-
-        scenario1_1(dataset);
-        scenario1_2(dataset);
-        scenario2_1(dataset, groupSize);
-        if (r2.groupSize2_1 != -1)
-            scenario2_2(dataset, increase);
-        scenario2_3(dataset);
-        scenario2_4(dataset, r2.path2_3);
-        scenario2_5(dataset, r2.path2_3);
-
-        out << name << ',' << r1.capacity1_1 << ',' << r1.connections1_1 << ','
-            << r1.runtime1_1.count() << ',' << r1.capacity1_2 << ','
-            << r1.connections1_2 << ',' << r1.runtime1_2.count() << ','
-            << r2.groupSize2_1 << ',' << r2.runtime2_1.count() << ','
-            << r2.increase2_2 << ',' << r2.requiresNewPath2_2 << ','
-            << r2.runtime2_2.count() << ',' << r2.maxFlow2_3 << ','
-            << r2.runtime2_3.count() << ',' << r2.earliestFinish2_4 << ','
-            << r2.runtime2_4.count() << ',' << r2.maxWaitTime2_5 << ','
-            << r2.runtime2_5.count() << '\n';
-    }
+/**
+ * @brief Runs all scenarios on a dataset.
+ *
+ * @return The line of the output file with the results.
+ */
+static std::string runDatasetScenarios(const std::string &name,
+                                       Dataset &dataset, int groupSize,
+                                       int increase) {
+    auto &r1 = dataset.getScenario1Result();
+    auto &r2 = dataset.getScenario2Result();
+
+    scenario1_1(dataset);
+    scenario1_2(dataset);
+
+    // time the other engines first, so that the paths that are kept are
+    // the ones found by Edmonds-Karp
+    runFlowScenarios(dataset, groupSize, increase, FlowEngine::DINIC);
+    auto dinic2_1 = r2.runtime2_1, dinic2_2 = r2.runtime2_2,
+         dinic2_3 = r2.runtime2_3;
+
+    runFlowScenarios(dataset, groupSize, increase, FlowEngine::PUSH_RELABEL);
+    auto pushRelabel2_1 = r2.runtime2_1, pushRelabel2_2 = r2.runtime2_2,
+         pushRelabel2_3 = r2.runtime2_3;
+
+    runFlowScenarios(dataset, groupSize, increase, FlowEngine::EDMONDS_KARP);
+    scenario2_4(dataset, r2.path2_3);
+    scenario2_5(dataset, r2.path2_3);
+
+    std::ostringstream out{};
+
+    out << name << ',' << r1.capacity1_1 << ',' << r1.connections1_1 << ','
+        << r1.runtime1_1.count() << ',' << r1.capacity1_2 << ','
+        << r1.connections1_2 << ',' << r1.runtime1_2.count() << ','
+        << r2.groupSize2_1 << ',' << r2.runtime2_1.count() << ','
+        << r2.increase2_2 << ',' << r2.requiresNewPath2_2 << ','
+        << r2.runtime2_2.count() << ',' << r2.maxFlow2_3 << ','
+        << r2.runtime2_3.count() << ',' << r2.earliestFinish2_4 << ','
+        << r2.runtime2_4.count() << ',' << r2.maxWaitTime2_5 << ','
+        << r2.runtime2_5.count() << ',' << dinic2_1.count() << ','
+        << dinic2_2.count() << ',' << dinic2_3.count() << ','
+        << pushRelabel2_1.count() << ',' << pushRelabel2_2.count() << ','
+        << pushRelabel2_3.count();
+
+    for (const PerfSample *sample :
+         {&r1.counters1_1, &r1.counters1_2, &r2.counters2_1, &r2.counters2_2,
+          &r2.counters2_3, &r2.counters2_4, &r2.counters2_5})
+        out << ',' << sample->cycles << ',' << sample->instructions << ','
+            << sample->cacheMisses << ',' << sample->branchMisses << ','
+            << sample->pageFaults;
+
+    for (const MemorySample *usage :
+         {&r1.memory1_1, &r1.memory1_2, &r2.memory2_1, &r2.memory2_2,
+          &r2.memory2_3, &r2.memory2_4, &r2.memory2_5})
+        out << ',' << usage->allocatedBytes << ',' << usage->allocations << ','
+            << usage->peakRss;
+
+    for (const WorkCounters *work : {&r1.work1_1, &r1.work1_2, &r2.work2_1,
+                                     &r2.work2_2, &r2.work2_3})
+        for (long long value : work->values())
+            out << ',' << value;
+
+    out << '\n';
+
+    return out.str();
 }
 
-void scenario1_1(Dataset &dataset) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+bool solveDatasets(
+    const std::vector<std::string> &names, unsigned threads,
+    const std::function<std::string(const std::string &, Dataset &)> &solve,
+    const std::function<void(const std::string &)> &write) {
+    if (threads == 0)
+        threads = std::max(std::thread::hardware_concurrency(), 1u);
+    threads = std::max<size_t>(std::min<size_t>(threads, names.size()), 1);
+
+#ifdef ALLOCATION_TRACKING
+    // the peak RSS is shared by the whole process, and each scenario resets
+    // it, so it would mix the scenarios of every dataset being solved
+    threads = 1;
+#endif
+
+    // each worker takes the next dataset nobody has taken yet, and the lines
+    // are written as soon as every dataset before them is done
+    std::vector<std::optional<std::string>> lines(names.size());
+    std::atomic<size_t> nextDataset{0};
+    std::atomic<bool> failed{false};
+    std::mutex mutex{};
+    std::condition_variable lineDone{};
+
+    auto worker = [&]() {
+        for (size_t i = nextDataset++; i < names.size(); i = nextDataset++) {
+            std::string line{};
+
+            try {
+                if (!std::filesystem::exists(DATASETS_PATH + names[i]))
+                    throw ParseError{names[i] + ": no such dataset"};
+
+                Dataset dataset = Dataset::load(names[i]);
+
+                if (dataset.getN() == -1)
+                    throw ParseError{names[i] + ": not a dataset"};
+
+                line = solve(names[i], dataset);
+            } catch (const ParseError &e) {
+                failed = true;
+
+                std::lock_guard lock{mutex};
+                std::cerr << e.what() << '\n';
+            } catch (const std::exception &e) {
+                // anything else, like running out of memory, only fails this
+                // dataset instead of escaping the thread
+                failed = true;
+
+                std::lock_guard lock{mutex};
+                std::cerr << names[i] << ": " << e.what() << '\n';
+            }
 
-    auto &nodes = dataset.getGraph().getNodes();
+            std::lock_guard lock{mutex};
+            lines[i] = std::move(line);
+            lineDone.notify_one();
+        }
+    };
 
-    std::vector<int> capacities(static_cast<int>(nodes.size()) + 1, 0);
-    std::set<std::pair<int /* capacity */, int /* node */>,
-             std::greater<std::pair<int, int>>>
-        capacitiesHeap;
+    std::vector<std::thread> workers{};
+    for (unsigned i = 0; i < threads; ++i)
+        workers.emplace_back(worker);
 
-    for (auto &[index, node] : nodes) {
-        capacitiesHeap.insert({0, index});
-        capacities.at(index) = 0;
-        node.parent = -1;
+    for (size_t i = 0; i < names.size(); ++i) {
+        std::unique_lock lock{mutex};
+        lineDone.wait(lock, [&]() { return lines[i].has_value(); });
+
+        if (!lines[i]->empty())
+            write(*lines[i]);
+        lines[i].reset();
     }
 
-    capacitiesHeap.erase({0, 1});
-    capacitiesHeap.insert({INF, 1});
-    capacities.at(1) = INF;
-    nodes[1].parent = 1;
+    for (auto &w : workers)
+        w.join();
+
+    return !failed;
+}
 
-    while (!capacitiesHeap.empty()) {
-        int v = capacitiesHeap.extract(capacitiesHeap.begin()).value().second;
+void runAllScenarios(int groupSize, int increase, unsigned threads) {
+    std::ofstream out{OUTPUT_PATH + OUTPUT_FILE};
+    out << OUTPUT_HEADER;
 
-        auto &orig = nodes.at(v);
+    solveDatasets(
+        Dataset::getAvailableDatasets(), threads,
+        [&](const std::string &name, Dataset &dataset) {
+            return runDatasetScenarios(name, dataset, groupSize, increase);
+        },
+        [&](const std::string &line) { out << line; });
+}
 
-        for (auto &[w, edge] : orig.adj) {
-            if (std::min(capacities[v], edge.capacity) > capacities[w]) {
-                capacitiesHeap.erase({capacities[w], w});
-                capacities[w] = std::min(capacities[v], edge.capacity);
-                nodes.at(w).parent = v;
-                capacitiesHeap.insert({capacities[w], w});
-            }
-        }
-    }
+void scenario1_1(Dataset &dataset) {
+    TraceSpan span{"scenario1_1"};
+
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+
+    const auto &graph = dataset.getGraph();
+    int n = graph.getN();
+
+    TraversalWorkspace workspace{};
+    int capacity = graph.widestPath(1, n, workspace);
 
     auto &result = dataset.getScenario1Result();
     result.path1_1.clear();
-    int node = nodes.size();
-    result.path1_1.addNode(node);
     result.connections1_1 = 0;
 
-    while (node != 1) {
-        result.path1_1.addNode(nodes.at(node).parent);
-        result.path1_1.addEdge(nodes.at(node).parent, node, -1, -1);
-        ++result.connections1_1;
-        node = nodes.at(node).parent;
+    if (capacity == -1) {
+        result.connections1_1 = -1;
+    } else {
+        int node = n;
+        result.path1_1.addNode(node);
+
+        while (node != 1) {
+            int parent = workspace.getParent(node);
+
+            result.path1_1.addNode(parent);
+            result.path1_1.addEdge(parent, node, -1, -1);
+            ++result.connections1_1;
+            node = parent;
+        }
     }
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
 
-    result.capacity1_1 = capacities[nodes.size()];
+    result.capacity1_1 = capacity;
     result.runtime1_1 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters1_1 = sample;
+    result.memory1_1 = usage;
+    result.work1_1 = workspace.getWorkCounters();
 }
 
 void scenario1_2(Dataset &dataset) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+    TraceSpan span{"scenario1_2"};
 
-    auto &nodes = dataset.getGraph().getNodes();
-    dataset.getGraph().bfs(1, nodes.size());
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+
+    const auto &graph = dataset.getGraph();
+    TraversalWorkspace forward{}, backward{};
+    int meet = graph.bidirectionalBfs(1, graph.getN(), forward, backward);
 
     auto &result = dataset.getScenario1Result();
     result.path1_2.clear();
-    int node = nodes.size();
-    result.path1_2.addNode(node);
     result.connections1_2 = 0;
     result.capacity1_2 = INT_MAX;
 
-    while (node != 1) {
-        auto parent = nodes.at(node).parent;
-        auto edge = nodes.at(parent).adj.at(node);
-        if (edge.capacity < result.capacity1_2)
-            result.capacity1_2 = edge.capacity;
+    if (meet == -1) {
+        result.connections1_2 = result.capacity1_2 = -1;
+    } else {
+        result.path1_2.addNode(meet);
+
+        // from the meeting node back to the start
+        for (int node = meet; node != 1;) {
+            int parent = forward.getParent(node);
+            int capacity = graph.getCapacity(forward.getParentEdge(node));
+            if (capacity < result.capacity1_2)
+                result.capacity1_2 = capacity;
+
+            result.path1_2.addNode(parent);
+            result.path1_2.addEdge(parent, node, -1, -1);
+            ++result.connections1_2;
+            node = parent;
+        }
 
-        result.path1_2.addNode(nodes.at(node).parent);
-        result.path1_2.addEdge(nodes.at(node).parent, node, -1, -1);
-        ++result.connections1_2;
-        node = nodes.at(node).parent;
+        // and from the meeting node to the end
+        for (int node = meet; node != graph.getN();) {
+            int next = backward.getParent(node);
+            int capacity = graph.getCapacity(backward.getParentEdge(node));
+            if (capacity < result.capacity1_2)
+                result.capacity1_2 = capacity;
+
+            result.path1_2.addNode(next);
+            result.path1_2.addEdge(node, next, -1, -1);
+            ++result.connections1_2;
+            node = next;
+        }
     }
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
 
     result.runtime1_2 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters1_2 = sample;
+    result.memory1_2 = usage;
+    result.work1_2 = forward.getWorkCounters();
+    result.work1_2 += backward.getWorkCounters();
 }
 
-void scenario2_1(Dataset &dataset, int groupSize) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+void scenario2_1(Dataset &dataset, int groupSize, FlowEngine engine) {
+    TraceSpan span{"scenario2_1"};
+
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
 
-    auto [flow, graph] =
-        dataset.getGraph().edmondsKarp(1, dataset.getN(), groupSize);
+    auto network = std::make_shared<ResidualNetwork>(dataset.getGraph());
+    int flow = network->maxFlow(engine, 1, dataset.getN(), groupSize);
+    WorkCounters work = network->getWorkCounters();
 
     auto &result = dataset.getScenario2Result();
 
+    result.curve2_1 = nullptr;
+
     if (flow < groupSize) {
         result.path2_1 = {};
+        result.network2_1 = nullptr;
         result.groupSize2_1 = -1;
     } else {
-        result.path2_1 = graph;
+        result.path2_1 = network->toGraph();
+        result.network2_1 = std::move(network);
         result.groupSize2_1 = groupSize;
     }
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
+
+    // the path is found again outside of the timed part, see pathEngine()
+    if (pathEngine(engine) != engine && result.groupSize2_1 != -1) {
+        network = std::make_shared<ResidualNetwork>(dataset.getGraph());
+        network->maxFlow(pathEngine(engine), 1, dataset.getN(), groupSize);
+
+        result.path2_1 = network->toGraph();
+        result.network2_1 = std::move(network);
+    }
 
     result.runtime2_1 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters2_1 = sample;
+    result.memory2_1 = usage;
+    result.work2_1 = work;
 }
 
-void scenario2_2(Dataset &dataset, int increase) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+std::vector<Scenario2Result>
+scenario2_1Sweep(Dataset &dataset, const std::vector<int> &groupSizes,
+                 FlowEngine engine) {
+    // the curve needs augmenting paths, and is only worth recording if it is
+    // shared
+    if (groupSizes.size() == 1 || pathEngine(engine) != engine) {
+        std::vector<Scenario2Result> results{};
+
+        for (int groupSize : groupSizes) {
+            scenario2_1(dataset, groupSize, engine);
+            results.push_back(dataset.getScenario2Result());
+        }
+
+        return results;
+    }
+
+    TraceSpan span{"scenario2_1Sweep"};
+
+    // only the fields of 2.1 change, so that the results of the other
+    // scenarios are kept when the last one is left in the dataset
+    std::vector<Scenario2Result> results(groupSizes.size(),
+                                         dataset.getScenario2Result());
+    std::shared_ptr<const FlowCurve> curve{};
+
+    for (size_t i = 0; i < groupSizes.size(); ++i) {
+        int groupSize = groupSizes[i];
+        Scenario2Result &result = results[i];
+
+        MemoryTracker memory{};
+        memory.start();
+        auto &counters = PerfCounters::forThisThread();
+        counters.start();
+        auto tstart = std::chrono::steady_clock::now();
+
+        if (curve == nullptr) {
+            int limit = *std::max_element(groupSizes.begin(), groupSizes.end());
+            curve = std::make_shared<const FlowCurve>(
+                dataset.getGraph(), engine, 1, dataset.getN(), limit);
+            result.work2_1 = curve->getWorkCounters();
+        } else {
+            result.work2_1 = {};
+        }
 
+        auto [flow, path] = curve->flowFor(groupSize);
+
+        result.network2_1 = nullptr;
+
+        if (flow < groupSize) {
+            result.path2_1 = {};
+            result.curve2_1 = nullptr;
+            result.groupSize2_1 = -1;
+        } else {
+            result.path2_1 = std::move(path);
+            result.curve2_1 = curve;
+            result.groupSize2_1 = groupSize;
+        }
+
+        auto tend = std::chrono::steady_clock::now();
+        auto sample = counters.stop();
+        auto usage = memory.stop();
+
+        result.runtime2_1 =
+            std::chrono::duration_cast<std::chrono::microseconds>(tend -
+                                                                  tstart);
+        result.counters2_1 = sample;
+        result.memory2_1 = usage;
+    }
+
+    if (!results.empty())
+        dataset.getScenario2Result() = results.back();
+
+    return results;
+}
+
+/**
+ * @brief Sends the increase of scenario 2.2 on top of the flow of scenario
+ *        2.1, and stores the new path in the results.
+ *
+ * @return The work done by the flow algorithm.
+ */
+static WorkCounters resumeFlow(Dataset &dataset, int increase,
+                               FlowEngine engine) {
     auto &result = dataset.getScenario2Result();
+
+    // a sweep of 2.1 only keeps its curve, which the network is rebuilt from
+    std::optional<ResidualNetwork> rebuilt{};
+    if (result.network2_1 == nullptr)
+        rebuilt = result.curve2_1->networkFor(result.groupSize2_1);
+
+    const ResidualNetwork &previous =
+        rebuilt ? *rebuilt : *result.network2_1;
+    const CsrGraph &graph = dataset.getGraph();
+    int n = dataset.getN();
+
     result.increase2_2 = increase;
-    int newGroupSize = result.groupSize2_1 + increase;
 
-    auto [flow, graph] = result.path2_1.edmondsKarp(1, dataset.getN());
+    // the edges of the path from 2.1, carrying the flow they had in 2.1
+    CsrGraph path{result.path2_1};
+    ResidualNetwork pathNetwork{path};
+
+    for (int src = 1; src <= path.getN(); ++src)
+        for (int e = path.edgesBegin(src); e < path.edgesEnd(src); ++e)
+            pathNetwork.sendFlow(
+                e, previous.getFlow(graph.findEdge(src, path.getDest(e))));
+
+    auto [added, delta] = pathNetwork.addFlow(engine, 1, n, increase);
+    WorkCounters work = pathNetwork.getWorkCounters();
 
-    result.requiresNewPath2_2 = flow < newGroupSize;
-    result.path2_2 = graph;
+    result.requiresNewPath2_2 = added < increase;
+    result.path2_2 = pathNetwork.toGraph();
+    result.delta2_2 = delta;
 
     if (result.requiresNewPath2_2) {
-        auto [flow, graph] =
-            dataset.getGraph().edmondsKarp(1, dataset.getN(), newGroupSize);
-        result.path2_2 = graph;
+        // 2.1 may be asked for other increases, so its flow is left as is
+        ResidualNetwork network = previous;
+        network.clearWorkCounters();
 
-        if (flow < newGroupSize) {
+        auto [added, delta] = network.addFlow(engine, 1, n, increase);
+        work += network.getWorkCounters();
+
+        result.path2_2 = network.toGraph();
+        result.delta2_2 = delta;
+
+        if (added < increase) {
             result.path2_2 = {};
+            result.delta2_2 = {};
             result.increase2_2 = -1;
             result.requiresNewPath2_2 = false;
         }
     }
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    return work;
+}
+
+void scenario2_2(Dataset &dataset, int increase, FlowEngine engine) {
+    TraceSpan span{"scenario2_2"};
 
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+
+    WorkCounters work = resumeFlow(dataset, increase, engine);
+
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
+
+    // the path is found again outside of the timed part, see pathEngine()
+    if (pathEngine(engine) != engine)
+        resumeFlow(dataset, increase, pathEngine(engine));
+
+    auto &result = dataset.getScenario2Result();
     result.runtime2_2 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters2_2 = sample;
+    result.memory2_2 = usage;
+    result.work2_2 = work;
 }
 
-void scenario2_3(Dataset &dataset) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+void scenario2_3(Dataset &dataset, FlowEngine engine) {
+    TraceSpan span{"scenario2_3"};
 
-    auto [flow, graph] = dataset.getGraph().edmondsKarp(1, dataset.getN());
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+
+    WorkCounters work{};
+    auto [flow, graph] = dataset.getGraph().maxFlow(engine, 1, dataset.getN(),
+                                                    INT_MAX, &work);
 
     auto &result = dataset.getScenario2Result();
     result.path2_3 = graph;
     result.maxFlow2_3 = flow;
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
+
+    // the path is found again outside of the timed part, see pathEngine()
+    if (pathEngine(engine) != engine)
+        result.path2_3 =
+            dataset.getGraph().maxFlow(pathEngine(engine), 1, dataset.getN())
+                .second;
 
     result.runtime2_3 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters2_3 = sample;
+    result.memory2_3 = usage;
+    result.work2_3 = work;
 }
 
-void scenario2_4(Dataset &dataset, Graph &graph) {
-    auto tstart = std::chrono::high_resolution_clock::now();
-
-    auto &nodes = graph.getNodes();
+int earliestStartTimes(const CsrGraph &graph, std::vector<int> &earliestStart,
+                       std::vector<int> &earliestArrival) {
+    int n = graph.getN();
 
-    std::unordered_map<int, int> earliestStart;
-    std::unordered_map<int, int> entryDegree;
+    earliestStart.assign(n + 1, 0);
+    earliestArrival.assign(n + 1, INT_MAX);
+    std::vector<int> entryDegree(n + 1, 0);
     int minDuration = -1;
 
-    for (const auto &[index, node] : nodes) {
-        // just to guarantee that nodes with degree 0 are added too
-        entryDegree[index] += 0;
-        earliestStart[index] = 0;
-
-        for (const auto &[dest, edge] : node.adj) {
-            entryDegree[dest]++;
-        }
-    }
+    for (int e = 0; e < graph.getEdgeCount(); ++e)
+        entryDegree[graph.getDest(e)]++;
 
     std::queue<int> s;
 
-    for (const auto &[index, degree] : entryDegree) {
-        if (degree == 0)
+    for (int index = 1; index <= n; ++index)
+        if (entryDegree[index] == 0)
             s.push(index);
-    }
 
     while (!s.empty()) {
         int v = s.front();
@@ -228,53 +556,84 @@ void scenario2_4(Dataset &dataset, Graph &graph) {
         if (minDuration < earliestStart[v])
             minDuration = earliestStart[v];
 
-        auto node = nodes.find(v);
-
-        for (const auto &[w, edge] : node->second.adj) {
-            if (earliestStart[w] < earliestStart[v] + edge.duration)
-                earliestStart[w] = earliestStart[v] + edge.duration;
+        for (int e = graph.edgesBegin(v); e < graph.edgesEnd(v); ++e) {
+            int w = graph.getDest(e);
+            int arrival = earliestStart[v] + graph.getDuration(e);
 
-            auto &destNode = nodes[w];
-            destNode.maxTime = std::max(destNode.maxTime, earliestStart[w]);
-            destNode.minTime = std::min(destNode.minTime, earliestStart[w]);
+            earliestStart[w] = std::max(earliestStart[w], arrival);
+            earliestArrival[w] = std::min(earliestArrival[w], arrival);
 
             if (--entryDegree[w] == 0)
                 s.push(w);
         }
     }
 
+    return minDuration;
+}
+
+void scenario2_4(Dataset &dataset, const Graph &graph) {
+    TraceSpan span{"scenario2_4"};
+
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
+
+    std::vector<int> earliestStart, earliestArrival;
+    int minDuration =
+        earliestStartTimes(CsrGraph{graph}, earliestStart, earliestArrival);
+
     auto &result = dataset.getScenario2Result();
     result.earliestFinish2_4 = minDuration;
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
 
     result.runtime2_4 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters2_4 = sample;
+    result.memory2_4 = usage;
 }
 
-void scenario2_5(Dataset &dataset, Graph &graph) {
-    auto tstart = std::chrono::high_resolution_clock::now();
+void scenario2_5(Dataset &dataset, const Graph &graph) {
+    TraceSpan span{"scenario2_5"};
 
-    scenario2_4(dataset, graph);
+    MemoryTracker memory{};
+    memory.start();
+    auto &counters = PerfCounters::forThisThread();
+    counters.start();
+    auto tstart = std::chrono::steady_clock::now();
 
-    // ordering is useful to retrieve the maxWaitTime
-    std::multimap<int, int> waitTimes;
+    CsrGraph path{graph};
+    std::vector<int> earliestStart, earliestArrival;
 
-    auto &nodes = graph.getNodes();
     auto &result = dataset.getScenario2Result();
+    result.earliestFinish2_4 =
+        earliestStartTimes(path, earliestStart, earliestArrival);
+
+    // the group waits at a node from the first arrival until the last one
+    std::vector<int> waitTimes(path.getN() + 1, 0);
 
-    for (const auto &[index, node] : nodes)
-        waitTimes.insert({index != 1 ? node.maxTime - node.minTime : 0, index});
+    for (int index = 2; index <= path.getN(); ++index)
+        if (earliestArrival[index] != INT_MAX)
+            waitTimes[index] = earliestStart[index] - earliestArrival[index];
 
-    result.maxWaitTime2_5 = waitTimes.rbegin()->first;
+    result.maxWaitTime2_5 =
+        *std::max_element(waitTimes.begin() + 1, waitTimes.end());
 
     result.maxWaitNodes2_5.clear();
-    auto maxWaitTimeRange = waitTimes.equal_range(result.maxWaitTime2_5);
-    for (auto it = maxWaitTimeRange.first; it != maxWaitTimeRange.second; ++it)
-        result.maxWaitNodes2_5.push_back(it->second);
+    for (int index = 1; index <= path.getN(); ++index)
+        if (waitTimes[index] == result.maxWaitTime2_5)
+            result.maxWaitNodes2_5.push_back(index);
 
-    auto tend = std::chrono::high_resolution_clock::now();
+    auto tend = std::chrono::steady_clock::now();
+    auto sample = counters.stop();
+    auto usage = memory.stop();
 
     result.runtime2_5 =
         std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart);
+    result.counters2_5 = sample;
+    result.memory2_5 = usage;
 }
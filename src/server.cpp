@@ -0,0 +1,566 @@
+#include <pthread.h>
+#include <signal.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <charconv>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "../includes/constants.hpp"
+#include "../includes/latency_histogram.hpp"
+#include "../includes/scenarios.hpp"
+#include "../includes/server.hpp"
+#include "../includes/tracer.hpp"
+#include "../includes/utils.hpp"
+
+static const std::string USAGE =
+    "Usage: da_proj2 --serve [options] [dataset...]\n"
+    "\n"
+    "Loads the given datasets, or every available dataset, once and answers\n"
+    "queries about them, one per line.\n"
+    "\n"
+    "  -s, --socket PATH   listen on a Unix domain socket instead of reading\n"
+    "                      the standard input\n"
+    "  -e, --engine NAME   edmonds-karp (default), dinic or push-relabel\n"
+    "  -h, --help          show this message\n"
+    "\n"
+    "Queries:\n"
+    "  widest DATASET SOURCE SINK           capacity and connections of the\n"
+    "                                       widest path\n"
+    "  hops DATASET SOURCE SINK             capacity and connections of a\n"
+    "                                       path with the fewest connections\n"
+    "  flow DATASET SOURCE SINK GROUP_SIZE  how much of the group can travel\n"
+    "  maxflow DATASET SOURCE SINK          the largest group that can travel\n"
+    "  earliest DATASET SOURCE SINK         when the largest group arrives\n"
+    "  maxwait DATASET SOURCE SINK          the longest wait of the largest\n"
+    "                                       group, and where it waits\n"
+    "  datasets                             the loaded datasets\n"
+    "  stats                                how long each query took\n"
+    "  quit                                 end the connection\n";
+
+/**
+ * @brief The queries about a path, with how many numbers follow the dataset.
+ */
+static const std::map<std::string, int> PATH_QUERIES{
+    {"widest", 2},  {"hops", 2},     {"flow", 3},
+    {"maxflow", 2}, {"earliest", 2}, {"maxwait", 2}};
+
+/**
+ * @brief What every connection shares, which never changes while the server
+ *        runs, apart from the atomic latency counters.
+ */
+struct ServerState {
+    /** @brief The loaded graphs, by dataset name. */
+    std::map<std::string, CsrGraph> graphs{};
+    /** @brief The algorithm flows are calculated with. */
+    FlowEngine engine = FlowEngine::EDMONDS_KARP;
+    /** @brief How long each query took, by query. */
+    std::map<std::string, LatencyHistogram> latencies{};
+};
+
+/**
+ * @brief The state of the searches of a connection, kept between queries so
+ *        that they don't have to allocate it again.
+ */
+struct ConnectionWorkspace {
+    TraversalWorkspace forward{};
+    TraversalWorkspace backward{};
+};
+
+/**
+ * @brief Thrown when a query can't be answered, with the reason.
+ */
+class QueryError : public std::runtime_error {
+public:
+    using std::runtime_error::runtime_error;
+};
+
+/**
+ * @brief Answers a query about a path.
+ *
+ * @return The results, without the leading ok.
+ */
+static std::string answerPathQuery(const ServerState &state,
+                                   ConnectionWorkspace &workspace,
+                                   const std::string &query,
+                                   const CsrGraph &graph,
+                                   const std::vector<int> &args) {
+    int source = args[0], sink = args[1];
+    std::ostringstream out{};
+
+    if (query == "widest") {
+        int capacity = graph.widestPath(source, sink, workspace.forward);
+        int connections = -1;
+
+        if (capacity != -1) {
+            connections = 0;
+
+            for (int node = sink; node != source;
+                 node = workspace.forward.getParent(node))
+                ++connections;
+        }
+
+        out << capacity << ' ' << connections;
+    } else if (query == "hops") {
+        int meet = graph.bidirectionalBfs(source, sink, workspace.forward,
+                                          workspace.backward);
+        int capacity = -1, connections = -1;
+
+        if (meet != -1) {
+            capacity = INT_MAX;
+            connections = 0;
+
+            for (int node = meet; node != source;
+                 node = workspace.forward.getParent(node), ++connections)
+                capacity = std::min(capacity,
+                                    graph.getCapacity(
+                                        workspace.forward.getParentEdge(node)));
+
+            for (int node = meet; node != sink;
+                 node = workspace.backward.getParent(node), ++connections)
+                capacity = std::min(
+                    capacity, graph.getCapacity(
+                                  workspace.backward.getParentEdge(node)));
+        }
+
+        out << capacity << ' ' << connections;
+    } else if (query == "flow") {
+        out << graph.maxFlow(state.engine, source, sink, args[2]).first;
+    } else {
+        // the times come from the path, see pathEngine()
+        auto [flow, path] = graph.maxFlow(
+            query == "maxflow" ? state.engine : pathEngine(state.engine),
+            source, sink);
+
+        if (query == "maxflow") {
+            out << flow;
+        } else {
+            CsrGraph paths{path};
+            std::vector<int> earliestStart, earliestArrival;
+            int finish =
+                earliestStartTimes(paths, earliestStart, earliestArrival);
+
+            if (query == "earliest") {
+                out << (flow == 0 ? -1 : finish);
+            } else {
+                // the group waits at a node from the first arrival until the
+                // last one
+                int maxWait = flow == 0 ? -1 : 0;
+                std::vector<int> nodes{};
+
+                for (int node = 1; flow != 0 && node <= paths.getN(); ++node) {
+                    if (earliestArrival[node] == INT_MAX)
+                        continue;
+
+                    int wait = earliestStart[node] - earliestArrival[node];
+
+                    if (wait > maxWait) {
+                        nodes.clear();
+                        maxWait = wait;
+                    }
+
+                    if (wait == maxWait)
+                        nodes.push_back(node);
+                }
+
+                out << maxWait;
+                for (int node : nodes)
+                    out << ' ' << node;
+            }
+        }
+    }
+
+    return out.str();
+}
+
+/**
+ * @brief Answers a query.
+ *
+ * @return The line to send back, without the line break, or nothing if the
+ *         connection should end.
+ */
+static std::optional<std::string> answer(ServerState &state,
+                                         ConnectionWorkspace &workspace,
+                                         std::string line) {
+    normalizeInput(line);
+    std::vector<std::string> words = split(line, ' ');
+
+    if (words.empty() || words[0].empty())
+        return "error empty query";
+
+    const std::string &query = words[0];
+
+    if (query == "quit")
+        return {};
+
+    if (query == "datasets") {
+        std::string result = "ok";
+        for (const auto &[name, graph] : state.graphs)
+            result += ' ' + name;
+        return result;
+    }
+
+    if (query == "stats") {
+        std::string result = "ok";
+        for (const auto &[name, histogram] : state.latencies)
+            result += ' ' + name + ": " + histogram.summary() + ';';
+        result.pop_back();
+        return result;
+    }
+
+    auto it = PATH_QUERIES.find(query);
+    if (it == PATH_QUERIES.end())
+        return "error unknown query '" + query + "'";
+
+    auto tstart = std::chrono::steady_clock::now();
+    std::string result;
+
+    try {
+        if (words.size() != (size_t)it->second + 2)
+            throw QueryError{"expected a dataset and " +
+                             std::to_string(it->second) + " numbers"};
+
+        auto graph = state.graphs.find(words[1]);
+        if (graph == state.graphs.end())
+            throw QueryError{"no dataset '" + words[1] + "'"};
+
+        std::vector<int> args{};
+
+        for (size_t i = 2; i < words.size(); ++i) {
+            int number;
+            const std::string &word = words[i];
+            auto [end, error] = std::from_chars(
+                word.data(), word.data() + word.size(), number);
+
+            if (error != std::errc{} || end != word.data() + word.size())
+                throw QueryError{"invalid number '" + word + "'"};
+
+            args.push_back(number);
+        }
+
+        int n = graph->second.getN();
+
+        if (args[0] < 1 || args[0] > n || args[1] < 1 || args[1] > n)
+            throw QueryError{"nodes must be from 1 to " + std::to_string(n)};
+        if (args[0] == args[1])
+            throw QueryError{"the source and the sink must differ"};
+        if (query == "flow" && args[2] < 1)
+            throw QueryError{"the group size must be positive"};
+
+        result = "ok " + answerPathQuery(state, workspace, query,
+                                         graph->second, args);
+    } catch (const QueryError &e) {
+        result = std::string{"error "} + e.what();
+    }
+
+    auto tend = std::chrono::steady_clock::now();
+    state.latencies.at(query).record(
+        std::chrono::duration_cast<std::chrono::microseconds>(tend - tstart));
+
+    return result;
+}
+
+/**
+ * @brief Writes the latency of each query to the standard error.
+ */
+static void printLatencies(const ServerState &state) {
+    for (const auto &[name, histogram] : state.latencies)
+        std::cerr << name << ": " << histogram.summary() << '\n';
+}
+
+/**
+ * @brief Answers the queries of a client of the socket, until it leaves.
+ */
+static void serveClient(ServerState &state, int fd) {
+    ConnectionWorkspace workspace{};
+    std::string pending{};
+    char buffer[4096];
+
+    while (true) {
+        ssize_t r = read(fd, buffer, sizeof buffer);
+        if (r <= 0)
+            return;
+
+        pending.append(buffer, r);
+
+        size_t start = 0, newline;
+        while ((newline = pending.find('\n', start)) != std::string::npos) {
+            auto response = answer(state, workspace,
+                                   pending.substr(start, newline - start));
+            start = newline + 1;
+
+            if (!response)
+                return;
+
+            *response += '\n';
+
+            for (size_t sent = 0; sent < response->size();) {
+                ssize_t w = send(fd, response->data() + sent,
+                                 response->size() - sent, MSG_NOSIGNAL);
+                if (w <= 0)
+                    return;
+                sent += w;
+            }
+        }
+
+        pending.erase(0, start);
+    }
+}
+
+/**
+ * @brief Blocks SIGINT and SIGTERM in the calling thread, and in every thread
+ *        it starts afterwards, so that they are only taken by the thread that
+ *        waits for them.
+ *
+ * @return The signals.
+ */
+static sigset_t blockStopSignals() {
+    sigset_t signals;
+    sigemptyset(&signals);
+    sigaddset(&signals, SIGINT);
+    sigaddset(&signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+    return signals;
+}
+
+/**
+ * @brief Answers the queries read from the standard input until it ends, or
+ *        until SIGINT or SIGTERM.
+ */
+static void serveStdin(ServerState &state) {
+    sigset_t signals = blockStopSignals();
+    std::atomic<bool> done{false};
+
+    // a read of the standard input can't be woken up, so the thread that
+    // takes the signals ends the program itself, after the summary
+    std::thread stopper{[&]() {
+        int signal;
+        sigwait(&signals, &signal);
+
+        if (done)
+            return;
+
+        printLatencies(state);
+        std::cout.flush();
+        Tracer::flush();
+        std::_Exit(0);
+    }};
+
+    ConnectionWorkspace workspace{};
+    std::string line;
+
+    while (std::getline(std::cin, line)) {
+        auto response = answer(state, workspace, line);
+        if (!response)
+            break;
+
+        std::cout << *response << std::endl;
+    }
+
+    done = true;
+    pthread_kill(stopper.native_handle(), SIGTERM);
+    stopper.join();
+}
+
+/**
+ * @brief Accepts clients on a Unix domain socket until SIGINT or SIGTERM.
+ *
+ * @return The exit status.
+ */
+static int serveSocket(ServerState &state, const std::string &path) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof address.sun_path) {
+        std::cerr << "da_proj2: socket path too long: " << path << '\n';
+        return 1;
+    }
+
+    std::strcpy(address.sun_path, path.c_str());
+
+    // only a socket left behind by an earlier server is replaced
+    struct stat info;
+    if (lstat(path.c_str(), &info) == 0) {
+        if (!S_ISSOCK(info.st_mode)) {
+            std::cerr << "da_proj2: " << path << " exists and isn't a socket\n";
+            return 1;
+        }
+
+        unlink(path.c_str());
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (listener == -1 ||
+        bind(listener, (sockaddr *)&address, sizeof address) == -1 ||
+        listen(listener, SOMAXCONN) == -1) {
+        std::cerr << "da_proj2: can't listen on " << path << ": "
+                  << std::strerror(errno) << '\n';
+        return 1;
+    }
+
+    // the signals are only taken by the thread that waits for them, which
+    // wakes everyone else up by shutting their sockets down
+    sigset_t signals = blockStopSignals();
+
+    std::mutex mutex{};
+    std::set<int> clients{};
+    bool stopping = false;
+
+    std::thread stopper{[&]() {
+        int signal;
+        sigwait(&signals, &signal);
+
+        std::lock_guard lock{mutex};
+        stopping = true;
+
+        shutdown(listener, SHUT_RDWR);
+        for (int fd : clients)
+            shutdown(fd, SHUT_RDWR);
+    }};
+
+    std::cerr << "Listening on " << path << '\n';
+
+    // the thread of each client, and the clients that have left, whose
+    // threads are joined as soon as the accept loop comes around
+    std::map<std::thread::id, std::thread> threads{};
+    std::vector<std::thread::id> finished{};
+
+    while (true) {
+        int fd = accept(listener, nullptr, nullptr);
+        int error = errno;
+
+        std::unique_lock lock{mutex};
+
+        if (stopping) {
+            if (fd != -1)
+                close(fd);
+            break;
+        }
+
+        for (std::thread::id id : finished) {
+            threads[id].join();
+            threads.erase(id);
+        }
+        finished.clear();
+
+        if (fd == -1) {
+            lock.unlock();
+
+            // errors like running out of descriptors last until a client
+            // leaves, so they are waited out instead of retried right away
+            if (error != EINTR && error != ECONNABORTED)
+                std::this_thread::sleep_for(std::chrono::milliseconds{100});
+            continue;
+        }
+
+        clients.insert(fd);
+
+        std::thread thread{[&, fd]() {
+            serveClient(state, fd);
+
+            std::lock_guard lock{mutex};
+            clients.erase(fd);
+            close(fd);
+            finished.push_back(std::this_thread::get_id());
+        }};
+        threads.emplace(thread.get_id(), std::move(thread));
+    }
+
+    // no thread is added anymore, and the ones still running don't touch it
+    for (auto &[id, thread] : threads)
+        thread.join();
+    stopper.join();
+
+    close(listener);
+    unlink(path.c_str());
+
+    return 0;
+}
+
+int runServer(int argc, char **argv) {
+    ServerState state{};
+    std::vector<std::string> names{};
+    std::string socketPath{};
+
+    for (int i = 2; i < argc; ++i) {
+        std::string arg = argv[i];
+
+        if (arg == "-h" || arg == "--help") {
+            std::cout << USAGE;
+            return 0;
+        }
+
+        if (!arg.starts_with('-')) {
+            names.push_back(arg);
+            continue;
+        }
+
+        if ((arg != "-s" && arg != "--socket" && arg != "-e" &&
+             arg != "--engine") ||
+            i + 1 == argc) {
+            std::cerr << "da_proj2: invalid option '" << arg << "'\n\n"
+                      << USAGE;
+            return 2;
+        }
+
+        std::string value = argv[++i];
+
+        if (arg == "-s" || arg == "--socket") {
+            socketPath = value;
+        } else if (auto engine = parseFlowEngine(value)) {
+            state.engine = *engine;
+        } else {
+            std::cerr << "da_proj2: unknown engine '" << value << "'\n\n"
+                      << USAGE;
+            return 2;
+        }
+    }
+
+    if (names.empty())
+        for (const std::string &name : Dataset::getAvailableDatasets())
+            if (name != OUTPUT_FILE)
+                names.push_back(name);
+
+    // the graphs are loaded once, on as many threads as there are cores
+    std::mutex mutex{};
+    bool loaded = solveDatasets(
+        names, 0,
+        [&](const std::string &name, Dataset &dataset) {
+            std::lock_guard lock{mutex};
+            state.graphs.insert({name, dataset.getGraph()});
+            return name;
+        },
+        [](const std::string &) {});
+
+    if (!loaded)
+        return 1;
+
+    for (const auto &[query, numbers] : PATH_QUERIES)
+        state.latencies[query];
+
+    int status = 0;
+
+    if (socketPath.empty())
+        serveStdin(state);
+    else
+        status = serveSocket(state, socketPath);
+
+    printLatencies(state);
+    return status;
+}
@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "../includes/buffered_writer.hpp"
+#include "../includes/tracer.hpp"
+
+/**
+ * @brief A span, as it is kept in a ring buffer.
+ */
+struct TraceEvent {
+    /** @brief The name of the span */
+    const char *name;
+    /** @brief The name of the value shown with the span, or nullptr */
+    const char *argName;
+    /** @brief The value shown with the span */
+    long long arg;
+    /** @brief When the span started, in nanoseconds */
+    long long start;
+    /** @brief When the span ended, in nanoseconds */
+    long long end;
+};
+
+/**
+ * @brief The spans recorded by a thread.
+ */
+struct TraceBuffer {
+    /** @brief How many spans are kept before the oldest are overwritten */
+    static constexpr size_t CAPACITY = 1 << 14;
+
+    /** @brief The spans, the one with index i in position i % CAPACITY */
+    std::unique_ptr<TraceEvent[]> events{new TraceEvent[CAPACITY]};
+    /**
+     * @brief How many spans were ever recorded, only written by the thread
+     *        that owns this buffer
+     */
+    std::atomic<size_t> head{0};
+    /** @brief The id of the thread in the trace */
+    int tid;
+};
+
+/**
+ * @brief Where the trace will be written.
+ */
+static std::string tracePath{};
+/**
+ * @brief When tracing was enabled, which is the start of the timeline.
+ */
+static long long origin = 0;
+/**
+ * @brief Guards the list of buffers.
+ */
+static std::mutex buffersMutex{};
+/**
+ * @brief The buffer of every thread that has recorded a span.
+ */
+static std::vector<std::unique_ptr<TraceBuffer>> buffers{};
+
+void Tracer::enable(const std::string &path) {
+    static std::once_flag once{};
+
+    std::call_once(once, [&]() {
+        tracePath = path;
+        origin = now();
+        std::atexit(flush);
+        active = true;
+    });
+}
+
+long long Tracer::now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void Tracer::record(const char *name, long long start, long long end,
+                    const char *argName, long long arg) {
+    thread_local TraceBuffer *buffer = nullptr;
+
+    // the only time a thread takes the lock is for its first span
+    if (buffer == nullptr) {
+        std::lock_guard lock{buffersMutex};
+
+        buffers.push_back(std::make_unique<TraceBuffer>());
+        buffer = buffers.back().get();
+        buffer->tid = buffers.size();
+    }
+
+    size_t head = buffer->head.load(std::memory_order_relaxed);
+    buffer->events[head % TraceBuffer::CAPACITY] = {name, argName, arg, start,
+                                                    end};
+    buffer->head.store(head + 1, std::memory_order_release);
+}
+
+void Tracer::flush() {
+    if (!isEnabled())
+        return;
+
+    BufferedWriter out{tracePath};
+    char time[32];
+
+    // timestamps are in microseconds, but kept to the nanosecond
+    auto writeTime = [&](long long ns) {
+        std::snprintf(time, sizeof(time), "%lld.%03lld", ns / 1000, ns % 1000);
+        out.write(std::string_view{time});
+    };
+
+    out.write("{\"traceEvents\":[\n"
+              "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,"
+              "\"args\":{\"name\":\"da_proj2\"}}");
+
+    std::lock_guard lock{buffersMutex};
+
+    for (const auto &buffer : buffers) {
+        size_t head = buffer->head.load(std::memory_order_acquire);
+        size_t first =
+            head > TraceBuffer::CAPACITY ? head - TraceBuffer::CAPACITY : 0;
+
+        out.write(",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+                  "\"tid\":");
+        out.write(buffer->tid);
+        out.write(",\"args\":{\"name\":\"thread ");
+        out.write(buffer->tid);
+        out.write("\"}}");
+
+        for (size_t i = first; i < head; ++i) {
+            const TraceEvent &event = buffer->events[i % TraceBuffer::CAPACITY];
+
+            out.write(",\n{\"name\":\"");
+            out.write(event.name);
+            out.write("\",\"ph\":\"X\",\"pid\":1,\"tid\":");
+            out.write(buffer->tid);
+            out.write(",\"ts\":");
+            writeTime(std::max(event.start - origin, 0LL));
+            out.write(",\"dur\":");
+            writeTime(event.end - event.start);
+
+            if (event.argName != nullptr) {
+                out.write(",\"args\":{\"");
+                out.write(event.argName);
+                out.write("\":");
+                out.write(event.arg);
+                out.write('}');
+            }
+
+            out.write('}');
+        }
+    }
+
+    out.write("\n]}\n");
+}
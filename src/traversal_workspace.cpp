@@ -0,0 +1,17 @@
+#include <algorithm>
+
+#include "../includes/traversal_workspace.hpp"
+
+void TraversalWorkspace::reset(int n) {
+    if (stamps.size() < (size_t)n + 1) {
+        stamps.resize(n + 1, 0);
+        parents.resize(n + 1, -1);
+        parentEdges.resize(n + 1, -1);
+    }
+
+    // stamps from before the epoch wrapped around would look visited again
+    if (++epoch == 0) {
+        std::fill(stamps.begin(), stamps.end(), 0);
+        epoch = 1;
+    }
+}
@@ -4,6 +4,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <random>
 #include <string>
 #include <vector>
 
@@ -13,6 +14,27 @@
 #include "../includes/ui.hpp"
 #include "../includes/utils.hpp"
 
+/**
+ * @brief Describes the memory a scenario used.
+ *
+ * @return The lines to show after its runtime, or an empty string if the
+ *         project was built without ALLOCATION_TRACKING.
+ */
+static std::string memoryUsage(const MemorySample &usage) {
+    if (usage.allocations == -1)
+        return "";
+
+    std::string result = "Allocated: " + std::to_string(usage.allocatedBytes) +
+                         " bytes in " + std::to_string(usage.allocations) +
+                         " allocations\n";
+
+    if (usage.peakRss != -1)
+        result +=
+            "Peak RSS: " + std::to_string(usage.peakRss / 1024) + " kB\n";
+
+    return result;
+}
+
 template <class T>
 std::optional<T> UserInterface::optionsMenu(const Options<T> &options) {
     for (int i{1}; i < options.size(); ++i) {
@@ -123,6 +145,12 @@ void UserInterface::show(Dataset &dataset) {
     case Menu::GENERATE_DATASET:
         generateDatasetMenu(dataset);
         break;
+    case Menu::CONVERT_DATASET:
+        convertDatasetMenu();
+        break;
+    case Menu::CHOOSE_FLOW_ENGINE:
+        chooseFlowEngineMenu();
+        break;
 
     case Menu::RENDER_VISUALIZATIONS:
         renderVisualizationsMenu(dataset);
@@ -184,6 +212,8 @@ void UserInterface::mainMenu() {
         {"Choose dataset", Menu::CHOOSE_DATASET},
         {"Choose scenario", Menu::CHOOSE_SCENARIO},
         {"Generate dataset", Menu::GENERATE_DATASET},
+        {"Convert dataset to binary snapshot", Menu::CONVERT_DATASET},
+        {"Choose flow algorithm", Menu::CHOOSE_FLOW_ENGINE},
         {"Visualize dataset (requires graphviz)", Menu::RENDER_VISUALIZATIONS},
     });
     currentMenu = menu.value_or(currentMenu);
@@ -247,7 +277,11 @@ void UserInterface::chooseDatasetMenu(Dataset &dataset) {
     if (selection == "")
         return;
 
-    dataset = Dataset::load(selection.value());
+    try {
+        dataset = Dataset::load(selection.value());
+    } catch (const ParseError &e) {
+        errorMessage = std::string{e.what()} + '\n';
+    }
 }
 
 void UserInterface::generateDatasetMenu(Dataset &dataset) {
@@ -264,10 +298,17 @@ void UserInterface::generateDatasetMenu(Dataset &dataset) {
             break;
     }
 
+    params.topology = (Topology)getUnsignedInput(
+        "Topology (0 uniform, 1 layered, 2 grid, 3 power-law, 4 long chain): ",
+        0, 4);
+
     params.numberOfNodes = getUnsignedInput("Number of nodes to generate: ", 1);
     params.numberOfEdges =
         getUnsignedInput("Number of edges to generate: ", 1,
-                         params.numberOfNodes * (params.numberOfNodes - 1) / 2);
+                         std::min<unsigned long>(
+                             (unsigned long)params.numberOfNodes *
+                                 (params.numberOfNodes - 1) / 2,
+                             INT_MAX));
 
     params.minEdgeCapacity = getUnsignedInput("Minimum edge capacity: ", 1);
     params.maxEdgeCapacity =
@@ -277,11 +318,67 @@ void UserInterface::generateDatasetMenu(Dataset &dataset) {
     params.maxEdgeDuration =
         getUnsignedInput("Maximum edge duration: ", params.minEdgeDuration);
 
+    params.seed = getUnsignedInput("Seed (0 for a random one): ");
+
+    if (params.seed == 0) {
+        std::random_device rd{};
+        params.seed = (uint64_t)rd() << 32 | rd();
+
+        // so that the dataset can be generated again
+        errorMessage = "Generated with seed " + std::to_string(params.seed) +
+                       ".\n";
+    }
+
     currentMenu = Menu::MAIN;
     dataset = Dataset::generate(name, params);
 }
 
-void UserInterface::scenarioOneMenu(Dataset &dataset) {
+void UserInterface::convertDatasetMenu() {
+    Options<std::string> options{{"Go back", ""}};
+
+    for (const auto &name : Dataset::getAvailableDatasets())
+        if (!name.ends_with(SNAPSHOT_EXTENSION))
+            options.push_back({name, name});
+
+    const auto selection = optionsMenu(options);
+
+    if (!selection.has_value())
+        return;
+
+    currentMenu = Menu::MAIN;
+
+    if (selection == "")
+        return;
+
+    try {
+        std::string snapshot = Dataset::convert(selection.value());
+
+        if (snapshot.empty())
+            errorMessage = "Couldn't convert " + selection.value() + "!\n";
+        else
+            getStringInput("Saved as " + snapshot +
+                           ", press enter to continue ");
+    } catch (const ParseError &e) {
+        errorMessage = std::string{e.what()} + '\n';
+    }
+}
+
+void UserInterface::chooseFlowEngineMenu() {
+    auto selection = optionsMenu<std::optional<FlowEngine>>({
+        {"Go back", {}},
+        {"Edmonds-Karp", FlowEngine::EDMONDS_KARP},
+        {"Dinic", FlowEngine::DINIC},
+        {"Push-relabel", FlowEngine::PUSH_RELABEL},
+    });
+
+    if (!selection.has_value())
+        return;
+
+    currentMenu = Menu::MAIN;
+    flowEngine = selection.value().value_or(flowEngine);
+}
+
+void UserInterface::scenarioOneMenu([[maybe_unused]] Dataset &dataset) {
     auto menu = optionsMenu<Menu>({
         {"Go back", Menu::CHOOSE_SCENARIO},
         {"Maximize group size", Menu::SCENARIO_1_1},
@@ -297,7 +394,8 @@ void UserInterface::scenario1_1Menu(Dataset &dataset) {
 
     std::cout << "Max capacity: " << result.capacity1_1
               << "\nNumber of connections: " << result.connections1_1
-              << "\nRuntime: " << result.runtime1_1.count() << "μs\n\n";
+              << "\nRuntime: " << result.runtime1_1.count() << "μs\n"
+              << memoryUsage(result.memory1_1) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -311,7 +409,8 @@ void UserInterface::scenario1_2Menu(Dataset &dataset) {
 
     std::cout << "Max capacity: " << result.capacity1_2
               << "\nNumber of connections: " << result.connections1_2
-              << "\nRuntime: " << result.runtime1_2.count() << "μs\n\n";
+              << "\nRuntime: " << result.runtime1_2.count() << "μs\n"
+              << memoryUsage(result.memory1_2) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -339,7 +438,7 @@ void UserInterface::scenarioTwoMenu(Dataset &dataset) {
 void UserInterface::scenario2_1Menu(Dataset &dataset) {
     int groupSize = getUnsignedInput("Group size: ");
 
-    scenario2_1(dataset, groupSize);
+    scenario2_1(dataset, groupSize, flowEngine);
 
     auto &result = dataset.getScenario2Result();
 
@@ -347,7 +446,8 @@ void UserInterface::scenario2_1Menu(Dataset &dataset) {
         std::cout << "No path found for that group size!\n";
     }
 
-    std::cout << "Runtime: " << result.runtime2_1.count() << "μs\n\n";
+    std::cout << "Runtime: " << result.runtime2_1.count() << "μs\n"
+              << memoryUsage(result.memory2_1) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -361,7 +461,7 @@ void UserInterface::scenario2_2Menu(Dataset &dataset) {
     prompt << "Group size increase (from " << result.groupSize2_1 << "): ";
     int increase = getUnsignedInput(prompt.str());
 
-    scenario2_2(dataset, increase);
+    scenario2_2(dataset, increase, flowEngine);
 
     if (result.increase2_2 == -1) {
         std::cout << "No path found for that group size increase!\n";
@@ -371,7 +471,8 @@ void UserInterface::scenario2_2Menu(Dataset &dataset) {
         std::cout << "That increase does not require a new path\n";
     }
 
-    std::cout << "Runtime: " << result.runtime2_2.count() << "μs\n\n";
+    std::cout << "Runtime: " << result.runtime2_2.count() << "μs\n"
+              << memoryUsage(result.memory2_2) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -379,12 +480,13 @@ void UserInterface::scenario2_2Menu(Dataset &dataset) {
 }
 
 void UserInterface::scenario2_3Menu(Dataset &dataset) {
-    scenario2_3(dataset);
+    scenario2_3(dataset, flowEngine);
 
     auto &result = dataset.getScenario2Result();
 
     std::cout << "Maximum flow: " << result.maxFlow2_3
-              << "\nRuntime: " << result.runtime2_3.count() << "μs\n\n";
+              << "\nRuntime: " << result.runtime2_3.count() << "μs\n"
+              << memoryUsage(result.memory2_3) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -423,7 +525,8 @@ void UserInterface::scenario2_4Menu(Dataset &dataset) {
     scenario2_4(dataset, graph);
 
     std::cout << "Earliest end time: " << result.earliestFinish2_4
-              << "\nRuntime: " << result.runtime2_4.count() << "μs\n\n";
+              << "\nRuntime: " << result.runtime2_4.count() << "μs\n"
+              << memoryUsage(result.memory2_4) << '\n';
 
     getStringInput("Press enter to continue ");
 
@@ -462,7 +565,8 @@ void UserInterface::scenario2_5Menu(Dataset &dataset) {
     scenario2_5(dataset, graph);
 
     std::cout << "Maximum wait time: " << result.maxWaitTime2_5
-              << "\nRuntime: " << result.runtime2_5.count() << "μs\n\n";
+              << "\nRuntime: " << result.runtime2_5.count() << "μs\n"
+              << memoryUsage(result.memory2_5) << '\n';
 
     if (!result.maxWaitNodes2_5.empty()) {
         std::cout << "Maximum wait time at node"
@@ -488,17 +592,26 @@ void UserInterface::scenario2_5Menu(Dataset &dataset) {
 void UserInterface::allScenariosMenu() {
     int groupSize = getUnsignedInput("Group size: ");
     int increase = getUnsignedInput("Group size increase: ");
+    unsigned threads =
+        getUnsignedInput("Number of threads (0 to use every core): ");
 
-    runAllScenarios(groupSize, increase);
+    runAllScenarios(groupSize, increase, threads);
 
     getStringInput("Press enter to continue ");
     currentMenu = Menu::MAIN;
 }
 
 void UserInterface::renderVisualizationsMenu(Dataset &dataset) {
+    int hops = -1;
+
+    if (dataset.getN() > VISUALIZATION_NODE_LIMIT)
+        hops = getUnsignedInput("The graph is large, show the nodes how many "
+                                "hops away from the paths? ",
+                                0, dataset.getN());
+
     std::cout << "Rendering visualizations, this may take a while...\n";
 
-    visualizations = dataset.render();
+    visualizations = dataset.render(hops);
 
     if (visualizations.empty()) {
         std::cout << "\nCould't render visualizations, make sure graphviz is "
@@ -511,7 +624,7 @@ void UserInterface::renderVisualizationsMenu(Dataset &dataset) {
     }
 }
 
-void UserInterface::visualizeDatasetMenu(Dataset &dataset) {
+void UserInterface::visualizeDatasetMenu([[maybe_unused]] Dataset &dataset) {
     Options<std::optional<Visualization>> possibleOptions{
         {"Go back", {}},
         {"Visualize graph", Visualization::DATASET},
@@ -0,0 +1,32 @@
+#include <algorithm>
+
+#include "../includes/work_counters.hpp"
+
+WorkCounters &WorkCounters::operator+=(const WorkCounters &other) {
+    augmentingPaths += other.augmentingPaths;
+    bfsPasses += other.bfsPasses;
+    nodesDequeued += other.nodesDequeued;
+    arcsScanned += other.arcsScanned;
+    pushes += other.pushes;
+    relabels += other.relabels;
+
+    if (minAugmentation == -1)
+        minAugmentation = other.minAugmentation;
+    else if (other.minAugmentation != -1)
+        minAugmentation = std::min(minAugmentation, other.minAugmentation);
+
+    maxAugmentation = std::max(maxAugmentation, other.maxAugmentation);
+
+    return *this;
+}
+
+std::array<long long, 8> WorkCounters::values() const {
+#ifdef WORK_COUNTERS
+    return {augmentingPaths, bfsPasses, nodesDequeued,   arcsScanned,
+            pushes,          relabels,  minAugmentation, maxAugmentation};
+#else
+    std::array<long long, 8> none{};
+    none.fill(-1);
+    return none;
+#endif
+}